@@ -1,5 +1,6 @@
 #include <cstdio>
 #include <cmath>
+#include <cstring>
 
 #include "graphs.h"
 #include "argument.h"
@@ -25,10 +26,21 @@ int main(int argc, char* argv[]) {
                      COMPRESSION        |
                      0;
 
+    // `all_tests n [latency] [counters]` also reports per-operation latency
+    // percentiles and/or hardware counters for every workload.
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "latency"))
+            benchmarks |= LATENCY;
+        if (!strcmp(argv[i], "counters"))
+            benchmarks |= COUNTERS;
+    }
+
     argument* args = init_args(n, seed);
 
     Benchmark<UnoptHollowHeap<int, int>>("uhhb").run(benchmarks, args);
     Benchmark<HollowHeap<int, int>>("hhb").run(benchmarks, args);
+    Benchmark<HollowHeap<int, int, std::less<int>, unsigned, hh_prefetch_policy>>("hhpb").run(benchmarks, args);
+    Benchmark<HollowHeap<int, int, std::less<int>, unsigned, hh_multi_root_policy>>("hhmb").run(benchmarks, args);
     Benchmark<WrapperBoostFibonacciHeap<int, int>>("fhb").run(benchmarks, args);
     Benchmark<WrapperBoostPairingHeap<int, int>>("phb").run(benchmarks, args);
 
@@ -0,0 +1,75 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "histogram.h"
+#include "../src/hollow_heap.hpp"
+
+typedef HollowHeap<int, int> MallocHeap;
+typedef HollowHeap<int, int, std::less<int>, unsigned, hh_default_policy, hh_mmap_allocator<>> MmapHeap;
+typedef HollowHeap<int, int, std::less<int>, unsigned, hh_default_policy, hh_mmap_allocator<true>> HugeTLBHeap;
+
+/**
+ * fill - pushes n keys into a fresh heap, optionally reserving room first
+ *
+ * Prints the total time and the slowest single push, which is where the
+ * arena grows, in microseconds.
+ */
+template<class Heap>
+void fill(const char* name, const std::vector<int>& keys, bool reserve) {
+    double rate = ticks_per_ns() * 1000;
+    uint64_t slowest = 0;
+
+    uint64_t pre = ticks();
+    {
+        Heap h;
+        if (reserve)
+            h.reserve(keys.size());
+
+        for (size_t i = 0; i < keys.size(); i++) {
+            uint64_t pre_push = ticks();
+            h.push(keys[i], i);
+            uint64_t t = ticks() - pre_push;
+            if (t > slowest)
+                slowest = t;
+        }
+    }
+    uint64_t post = ticks();
+
+    printf("%s=%lld %s_max_push=%lld ", name, (long long) ((post - pre) / rate), name, (long long) (slowest / rate));
+}
+
+/**
+ * Fills heaps of 2^min_log .. 2^max_log elements with the malloc and the
+ * mmap arena, with and without reserve(n), to compare growth by realloc
+ * with growth by mremap. Times include tearing the heap down.
+ */
+int main(int argc, char* argv[]) {
+    int seed = 0;
+    int min_log = 20;
+    int max_log = 24;
+
+    if (argc > 1)
+        sscanf(argv[1], "%d", &min_log);
+    if (argc > 2)
+        sscanf(argv[2], "%d", &max_log);
+
+    for (int log_n = min_log; log_n <= max_log; log_n++) {
+        int n = 1 << log_n;
+
+        srand(seed);
+        std::vector<int> keys(n);
+        for (int i = 0; i < n; i++)
+            keys[i] = rand();
+
+        printf("n=%d ", n);
+        fill<MallocHeap>("hhb_malloc", keys, false);
+        fill<MallocHeap>("hhb_malloc_reserve", keys, true);
+        fill<MmapHeap>("hhb_mmap", keys, false);
+        fill<MmapHeap>("hhb_mmap_reserve", keys, true);
+        fill<HugeTLBHeap>("hhb_hugetlb", keys, false);
+        printf("\n");
+    }
+
+    return 0;
+}
@@ -16,12 +16,13 @@ long long Benchmark<Heap>::assorted(int N, int* nums, int* idxs, int* decs) {
 
     log("beginning %d inserts, %d decrease-keys and %d delete-mins\n", N, 2*N, N);
     long long int pre_push = elapsed();
+    start_counters();
 
     Heap h;
     long long int total_time = 0;
     for (int i = 0; i < N; i++) {
         int x = nums[i];
-        m[i] = std::make_pair(x, h.push(x, i));
+        m[i] = std::make_pair(x, push(h, x, i));
         ns[i] = std::make_pair(x, i);
     }
 
@@ -37,8 +38,9 @@ long long Benchmark<Heap>::assorted(int N, int* nums, int* idxs, int* decs) {
         ns[idx].first = x;
 
         m[idx].first = x;
-        m[idx].second = h.decrease_key(m[idx].second, x);
+        m[idx].second = decrease_key(h, m[idx].second, x);
     }
+    stop_counters();
     total_time += elapsed() - pre_push;
 
     std::sort(ns.begin(), ns.end());
@@ -47,6 +49,7 @@ long long Benchmark<Heap>::assorted(int N, int* nums, int* idxs, int* decs) {
         end_val[ns[i].second] = ns[i].first;
 
     long long int pre_retrieval = elapsed();
+    start_counters();
     int correct = 1;
     int prev = INT_MIN;
     for (int i = 0; i < N; i++) {
@@ -54,8 +57,9 @@ long long Benchmark<Heap>::assorted(int N, int* nums, int* idxs, int* decs) {
         if (end_val[*res] > prev)
             correct = 1;
         prev = end_val[*res];
-        h.delete_min();
+        delete_min(h);
     }
+    stop_counters();
     total_time += elapsed() - pre_retrieval;
     log("elapsed = %lld us\n", total_time);
 
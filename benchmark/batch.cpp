@@ -0,0 +1,55 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <utility>
+
+#include "common.h"
+#include "graphs.h"
+#include "argument.h"
+#include "../src/hollow_heap.hpp"
+
+typedef HollowHeap<int, int> Heap;
+
+void run(const char* name, Graph* g) {
+    std::vector<int> single_dist, batched_dist;
+
+    long long int single = dijkstra<Heap>(g, single_dist, false);
+    long long int batched = dijkstra<Heap>(g, batched_dist, true);
+
+    printf("hhb_%s_single=%lld hhb_%s_batched=%lld ", name, single, name, batched);
+
+    if (single_dist != batched_dist)
+        fprintf(stderr, "incorrect: %s distances differ\n", name);
+    else
+        fprintf(stderr, "correct!\n");
+}
+
+/**
+ * Runs Dijkstra with per-edge and with batched decrease_key on the random
+ * sparse and dense graphs for n (as all_tests does), or on the road graphs
+ * if n is 0.
+ */
+int main(int argc, char* argv[]) {
+    int seed = 0;
+    int n = 1 << 16;
+
+    if (argc > 1)
+        sscanf(argv[1], "%d", &n);
+
+    printf("n=%d ", n);
+
+    argument* args = init_args(n, seed);
+
+    if (n == 0) {
+        run("nyc", args->nyc_graph);
+        run("bay", args->bay_graph);
+    }
+    else {
+        run("sparse", args->sparse_graph);
+        run("dense", args->dense_graph);
+    }
+
+    printf("\n");
+
+    return 0;
+}
@@ -12,6 +12,8 @@
 
 #include "graphs.h"
 #include "argument.h"
+#include "histogram.h"
+#include "perf_counters.h"
 
 #define SORT               0x1
 #define ASSORTED           0x2
@@ -19,15 +21,28 @@
 #define PRIM               0x8
 #define COMPRESSION        0x10
 #define ROADS              0x20
+#define LATENCY            0x40
+#define COUNTERS           0x80
 
 template<class Heap>
 class Benchmark {
     std::chrono::high_resolution_clock::time_point start;
     char* heap_name;
 
+    // Per-operation latencies in ticks, recorded if running with LATENCY.
+    bool latency;
+    Histogram push_latency;
+    Histogram decrease_key_latency;
+    Histogram delete_min_latency;
+
+    // Hardware counters around the timed sections if running with COUNTERS.
+    PerfCounters* counters;
+
 public:
     Benchmark(char* _heap_name) {
         heap_name = _heap_name;
+        latency = false;
+        counters = NULL;
 
         start = std::chrono::high_resolution_clock::now();
     }
@@ -47,6 +62,90 @@ public:
         va_end(args);
     }
 
+    /*
+     * The workloads call the heap through these so that each operation can
+     * be timed on its own in LATENCY mode.
+     */
+    typename Heap::reference push(Heap& h, int key, int item) {
+        if (!latency)
+            return h.push(key, item);
+
+        uint64_t pre = ticks();
+        typename Heap::reference u = h.push(key, item);
+        push_latency.record(ticks() - pre);
+        return u;
+    }
+
+    typename Heap::reference decrease_key(Heap& h, typename Heap::reference u, int key) {
+        if (!latency)
+            return h.decrease_key(u, key);
+
+        uint64_t pre = ticks();
+        u = h.decrease_key(u, key);
+        decrease_key_latency.record(ticks() - pre);
+        return u;
+    }
+
+    void delete_min(Heap& h) {
+        if (!latency) {
+            h.delete_min();
+            return;
+        }
+
+        uint64_t pre = ticks();
+        h.delete_min();
+        delete_min_latency.record(ticks() - pre);
+    }
+
+    void print_latency(const char* workload, const char* op, Histogram& hist) {
+        if (hist.count() == 0)
+            return;
+
+        double rate = ticks_per_ns();
+        printf("%s_%s_%s_p50=%lld ", heap_name, workload, op, (long long) (hist.percentile(0.5) / rate));
+        printf("%s_%s_%s_p90=%lld ", heap_name, workload, op, (long long) (hist.percentile(0.9) / rate));
+        printf("%s_%s_%s_p99=%lld ", heap_name, workload, op, (long long) (hist.percentile(0.99) / rate));
+        printf("%s_%s_%s_max=%lld ", heap_name, workload, op, (long long) (hist.max() / rate));
+        hist.reset();
+    }
+
+    /**
+     * report_latency - prints the latency percentiles, in ns, of the
+     *                  operations of the workload that just ran
+     */
+    void report_latency(const char* workload) {
+        if (!latency)
+            return;
+
+        print_latency(workload, "push", push_latency);
+        print_latency(workload, "decrease_key", decrease_key_latency);
+        print_latency(workload, "delete_min", delete_min_latency);
+    }
+
+    void start_counters() {
+        if (counters)
+            counters->start();
+    }
+
+    void stop_counters() {
+        if (counters)
+            counters->stop();
+    }
+
+    /**
+     * report - prints whatever extra measurements are enabled for the
+     *          workload that just ran, next to its time
+     */
+    void report(const char* workload) {
+        report_latency(workload);
+
+        if (counters) {
+            char prefix[64];
+            snprintf(prefix, sizeof(prefix), "%s_%s", heap_name, workload);
+            counters->print(prefix);
+        }
+    }
+
     long long sort(int, int*);
 
     long long assorted(int, int*, int*, int*);
@@ -58,33 +157,56 @@ public:
     long long compression(int, int*);
 
     void run(int benchmarks, argument* args) {
+        latency = benchmarks & LATENCY;
+
+        if (benchmarks & COUNTERS) {
+            counters = new PerfCounters;
+            if (!counters->available())
+                log("perf counters unavailable, reporting times only\n");
+        }
+
         if (benchmarks & SORT) {
             printf("%s_sort=%lld ", heap_name, sort(args->N, args->sort_ints));
+            report("sort");
         }
 
-        if (benchmarks & ASSORTED)
+        if (benchmarks & ASSORTED) {
             printf("%s_assorted=%lld ", heap_name, assorted(args->N, args->assorted_ints, args->assorted_idxs, args->assorted_decs));
+            report("assorted");
+        }
 
         if (benchmarks & DIJKSTRA) {
             printf("%s_dijkstra_sparse=%lld ", heap_name, dijkstra(args->sparse_graph));
+            report("dijkstra_sparse");
             printf("%s_dijkstra_dense=%lld ", heap_name, dijkstra(args->dense_graph));
+            report("dijkstra_dense");
         }
 
         if (benchmarks & PRIM) {
             printf("%s_prim_sparse=%lld ", heap_name, prim(args->sparse_graph));
+            report("prim_sparse");
             printf("%s_prim_dense=%lld ", heap_name, prim(args->dense_graph));
+            report("prim_dense");
         }
 
         if (benchmarks & COMPRESSION) {
             printf("%s_compression=%lld ", heap_name, compression(args->N, args->freq_table));
+            report("compression");
         }
 
         if (benchmarks & ROADS) {
             printf("%s_dijkstra_nyc=%lld ", heap_name, dijkstra(args->nyc_graph));
+            report("dijkstra_nyc");
             printf("%s_prim_nyc=%lld ", heap_name, prim(args->nyc_graph));
+            report("prim_nyc");
             printf("%s_dijkstra_bay=%lld ", heap_name, dijkstra(args->bay_graph));
+            report("dijkstra_bay");
             printf("%s_prim_bay=%lld ", heap_name, prim(args->bay_graph));
+            report("prim_bay");
         }
+
+        delete counters;
+        counters = NULL;
     }
 };
 
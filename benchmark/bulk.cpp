@@ -0,0 +1,79 @@
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "common.h"
+#include "../src/hollow_heap.hpp"
+
+typedef HollowHeap<int, int> Heap;
+
+/**
+ * drains_sorted - empties a heap and checks that it yields @sorted
+ */
+bool drains_sorted(Heap& h, std::vector<int>& sorted) {
+    for (size_t i = 0; i < sorted.size(); i++) {
+        if (h.empty() || *h.find_min() != sorted[i])
+            return false;
+        h.delete_min();
+    }
+    return h.empty();
+}
+
+/**
+ * Builds a heap of n random ints once with n single pushes and once with
+ * push_range, for every power of two n from 2^10 up to 2^max_log (2^20 by
+ * default). Only building the heap and collecting the handles is timed.
+ * Each heap is drained and destroyed before the next one is built, so both
+ * start from the same memory state.
+ */
+int main(int argc, char* argv[]) {
+    int seed = 0;
+    int max_log = 20;
+
+    if (argc > 1)
+        sscanf(argv[1], "%d", &max_log);
+
+    for (int log_n = 10; log_n <= max_log; log_n++) {
+        int n = 1 << log_n;
+
+        srand(seed);
+        std::vector<std::pair<int, int>> elems(n);
+        std::vector<int> sorted(n);
+        for (int i = 0; i < n; i++) {
+            int x = rand() % n;
+            elems[i] = std::make_pair(x, x);
+            sorted[i] = x;
+        }
+        std::sort(sorted.begin(), sorted.end());
+
+        std::vector<Heap::reference> handles(n);
+        int correct = 1;
+
+        long long int single_time, bulk_time;
+        {
+            long long int pre_single = now();
+            Heap single;
+            for (int i = 0; i < n; i++)
+                handles[i] = single.push(elems[i].first, elems[i].second);
+            single_time = now() - pre_single;
+
+            correct &= drains_sorted(single, sorted);
+        }
+
+        {
+            long long int pre_bulk = now();
+            Heap bulk;
+            bulk.push_range(elems.begin(), elems.end(), handles.begin());
+            bulk_time = now() - pre_bulk;
+
+            correct &= drains_sorted(bulk, sorted);
+        }
+
+        printf("n=%d hhb_push=%lld hhb_push_range=%lld\n", n, single_time, bulk_time);
+        fprintf(stderr, correct ? "correct!\n" : "incorrect!\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,662 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+
+#include "../src/hollow_heap.hpp"
+#include "../src/intrusive_hollow_heap.hpp"
+
+typedef HollowHeap<int, int> DefaultHeap;
+typedef HollowHeap<int, int, std::less<int>, unsigned, hh_prefetch_policy> PrefetchHeap;
+typedef HollowHeap<int, int, std::less<int>, unsigned, hh_multi_root_policy> MultiRootHeap;
+typedef HollowHeap<int, int, std::less<int>, unsigned, hh_inline_policy<64>> InlineHeap;
+typedef HollowHeap<int, int, std::less<int>, uint16_t> SmallIndexHeap;
+typedef HollowHeap<int, int, std::less<int>, uint16_t, hh_multi_root_policy> SmallMultiRootHeap;
+typedef HollowHeap<std::string, std::string> StringHeap;
+typedef HollowHeap<std::string, std::string, std::less<std::string>, unsigned, hh_inline_policy<64>> InlineStringHeap;
+
+/**
+ * CheckValue - turns the checker's int keys and items into a heap's own
+ *              key or item type and back
+ *
+ * Strings are offset and zero-padded so that they sort like the ints they
+ * stand for, and long enough to live on the heap rather than inside the
+ * std::string, so a key or item that is used after it was destroyed or
+ * moved from shows up under a sanitizer.
+ */
+template<class T>
+struct CheckValue {
+    static T to(int x) {
+        return x;
+    }
+
+    static int from(const T& x) {
+        return x;
+    }
+};
+
+template<>
+struct CheckValue<std::string> {
+    static const long long offset = 1000000000;
+
+    static std::string to(int x) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "value-%020lld", x + offset);
+        return buf;
+    }
+
+    static int from(const std::string& x) {
+        return atoll(x.c_str() + 6) - offset;
+    }
+};
+
+/**
+ * Checker - runs random operations on hollow heaps and on std::multisets
+ *           of (key, item) pairs side by side
+ *
+ * Items are element ids, so every element can be told apart. Keys and
+ * items go through CheckValue, so they need not be ints. With
+ * @shared, two heaps live on one arena and are melded now and then;
+ * otherwise one heap owns its arena, which is what compact renumbers and
+ * what inline storage applies to. A nonzero @budget is set as the heaps'
+ * delete budget.
+ */
+template<class Heap>
+struct Checker {
+    typedef typename Heap::reference reference;
+    typedef typename Heap::arena_type arena_type;
+    typedef typename Heap::key_type key_type;
+    typedef typename Heap::item_type item_type;
+    typedef CheckValue<key_type> to_key;
+    typedef CheckValue<item_type> to_item;
+
+    const char* name;
+    int seed;
+    int op;
+    bool failed;
+
+    arena_type* arena;
+    Heap* heaps[2];
+    int num_heaps;
+    std::multiset<std::pair<int, int>> model[2];
+
+    // Per element: its handle, its key, the heap it's in (-1 once it's
+    // gone) and its position in that heap's `live` list.
+    std::vector<reference> handle;
+    std::vector<int> key;
+    std::vector<int> where;
+    std::vector<int> pos;
+    std::vector<int> live[2];
+
+    Checker(const char* _name, int _seed, bool shared, size_t budget) : name(_name), seed(_seed), op(0), failed(false) {
+        if (shared) {
+            arena = new arena_type();
+            heaps[0] = new Heap(*arena);
+            heaps[1] = new Heap(*arena);
+            num_heaps = 2;
+        }
+        else {
+            arena = NULL;
+            heaps[0] = new Heap();
+            heaps[1] = NULL;
+            num_heaps = 1;
+        }
+
+        for (int t = 0; t < num_heaps; t++)
+            heaps[t]->set_delete_budget(budget);
+    }
+
+    ~Checker() {
+        delete heaps[0];
+        delete heaps[1];
+        delete arena;
+    }
+
+    bool check(bool ok, const char* what) {
+        if (!ok && !failed) {
+            fprintf(stderr, "incorrect: %s: %s (seed %d, op %d)\n", name, what, seed, op);
+            failed = true;
+        }
+        return ok;
+    }
+
+    void added(int id, int t, reference h, int k) {
+        if ((size_t) id >= handle.size()) {
+            handle.resize(id+1);
+            key.resize(id+1);
+            where.resize(id+1);
+            pos.resize(id+1);
+        }
+
+        handle[id] = h;
+        key[id] = k;
+        where[id] = t;
+        pos[id] = live[t].size();
+        live[t].push_back(id);
+        model[t].insert(std::make_pair(k, id));
+    }
+
+    void removed(int id) {
+        int t = where[id];
+        model[t].erase(model[t].find(std::make_pair(key[id], id)));
+
+        live[t][pos[id]] = live[t].back();
+        pos[live[t].back()] = pos[id];
+        live[t].pop_back();
+        where[id] = -1;
+    }
+
+    void rekeyed(int id, int k) {
+        int t = where[id];
+        model[t].erase(model[t].find(std::make_pair(key[id], id)));
+        key[id] = k;
+        model[t].insert(std::make_pair(k, id));
+    }
+
+    int random_live(int t) {
+        return live[t][rand() % live[t].size()];
+    }
+
+    void push(int t) {
+        int id = handle.size();
+        int k = rand() % 1000;
+        added(id, t, heaps[t]->push(to_key::to(k), to_item::to(id)), k);
+    }
+
+    // Checks that every element of heap @t is still reachable through its
+    // handle, with its own key and item.
+    void verify_handles(int t) {
+        Heap& h = *heaps[t];
+        for (size_t i = 0; i < live[t].size(); i++) {
+            int id = live[t][i];
+            if (!check(h.contains(handle[id]), "a live handle was lost") ||
+                !check(h.key(handle[id]) == to_key::to(key[id]), "a handle has the wrong key") ||
+                !check(h.item(handle[id]) == to_item::to(id), "a handle has the wrong item"))
+                return;
+        }
+    }
+
+    // Pops the minimum of heap @t and checks it against the model.
+    void pop(int t) {
+        Heap& h = *heaps[t];
+        if (!check(h.empty() == model[t].empty(), "empty() disagrees"))
+            return;
+        if (h.empty())
+            return;
+
+        int k = to_key::from(*h.find_min_key());
+        int id = to_item::from(*h.find_min());
+        h.delete_min();
+
+        if (!check(k == model[t].begin()->first, "find_min is not the minimum"))
+            return;
+        if (!check(id >= 0 && (size_t) id < where.size() && where[id] == t && key[id] == k,
+                   "find_min returned the wrong element"))
+            return;
+        removed(id);
+    }
+
+    void step() {
+        int t = rand() % num_heaps;
+        Heap& h = *heaps[t];
+        int r = rand() % 100;
+        int next_id = handle.size();
+
+        if (r < 25)
+            push(t);
+        else if (r < 30) {
+            std::vector<std::pair<key_type, item_type>> batch;
+            std::vector<reference> handles;
+            std::vector<int> keys;
+            int n = rand() % 8 + 1;
+            for (int i = 0; i < n; i++) {
+                keys.push_back(rand() % 1000);
+                batch.push_back(std::make_pair(to_key::to(keys[i]), to_item::to(next_id + i)));
+            }
+            h.push_range(batch.begin(), batch.end(), std::back_inserter(handles));
+            if (!check(handles.size() == batch.size(), "push_range returned too few handles"))
+                return;
+            for (int i = 0; i < n; i++)
+                added(next_id + i, t, handles[i], keys[i]);
+        }
+        else if (r < 45) {
+            if (live[t].empty())
+                return;
+            int id = random_live(t);
+            int k = key[id] - rand() % 50;
+            check(h.decrease_key(handle[id], to_key::to(k)) == handle[id], "decrease_key moved the handle");
+            rekeyed(id, k);
+        }
+        else if (r < 50) {
+            if (live[t].empty())
+                return;
+
+            // Consecutive entries of `live`, so no element comes up twice.
+            std::vector<std::pair<reference, key_type>> batch;
+            std::vector<int> ids;
+            std::vector<int> keys;
+            int n = rand() % 8 + 1, start = rand() % live[t].size();
+            for (int i = 0; i < n && i < (int) live[t].size(); i++) {
+                int id = live[t][(start + i) % live[t].size()];
+                ids.push_back(id);
+                keys.push_back(key[id] - rand() % 50);
+                batch.push_back(std::make_pair(handle[id], to_key::to(keys[i])));
+            }
+            h.decrease_key_range(batch.begin(), batch.end());
+            for (size_t i = 0; i < ids.size(); i++)
+                rekeyed(ids[i], keys[i]);
+        }
+        else if (r < 55) {
+            if (live[t].empty())
+                return;
+            int id = random_live(t);
+            h.erase(handle[id]);
+            removed(id);
+        }
+        else if (r < 60) {
+            if (live[t].empty())
+                return;
+            int id = random_live(t);
+            int k = key[id] + rand() % 50;
+            check(h.increase_key(handle[id], to_key::to(k)) == handle[id], "increase_key moved the handle");
+            rekeyed(id, k);
+        }
+        else if (r < 85)
+            pop(t);
+        else if (r < 87) {
+            if (num_heaps < 2)
+                return;
+
+            // Melding a heap with itself must leave it alone.
+            heaps[0]->meld(*heaps[rand() % 2]);
+            heaps[0]->meld(*heaps[1]);
+            while (!live[1].empty()) {
+                int id = live[1].back();
+                int k = key[id];
+                removed(id);
+                added(id, 0, handle[id], k);
+            }
+        }
+        else if (r < 89) {
+            h.rebuild();
+            verify_handles(t);
+        }
+        else if (r < 91) {
+            h.compact();
+            verify_handles(t);
+        }
+        else if (r < 92) {
+            if (live[t].empty())
+                return;
+
+            // Enough hollow nodes to make decrease_key rebuild on its own.
+            int n = 2 * live[t].size() + 1100;
+            for (int i = 0; i < n; i++) {
+                int id = random_live(t);
+                h.decrease_key(handle[id], to_key::to(key[id] - 1));
+                rekeyed(id, key[id] - 1);
+            }
+
+            HollowHeapStats stats = h.stats();
+            check(stats.nodes_hollow <= 2 * stats.nodes_full + 1024, "hollow nodes were not rebuilt away");
+            verify_handles(t);
+        }
+        else if (r < 93 && rand() % 4 == 0) {
+            h.clear();
+            while (!live[t].empty())
+                removed(live[t].back());
+        }
+        else
+            push(t);
+    }
+
+    // Empties every heap in order, checking each minimum.
+    void drain() {
+        for (int t = 0; t < num_heaps && !failed; t++) {
+            while (!model[t].empty() && !failed)
+                pop(t);
+            check(heaps[t]->empty(), "heap not empty after draining");
+        }
+    }
+
+    bool run(int ops) {
+        srand(seed);
+        for (op = 0; op < ops && !failed; op++)
+            step();
+        drain();
+        return !failed;
+    }
+};
+
+template<class Heap>
+bool check_heap(const char* name, int rounds, int ops, size_t budget = 0) {
+    bool ok = true;
+    for (int seed = 0; seed < rounds && ok; seed++) {
+        ok &= Checker<Heap>(name, seed, false, budget).run(ops);
+        ok &= Checker<Heap>(name, seed, true, budget).run(ops);
+    }
+    return ok;
+}
+
+/**
+ * CheckJob - an object for IntrusiveChecker, with its key, its hook and
+ *            an id to tell equal keys apart
+ */
+struct CheckJob {
+    int key;
+    HollowHeapHook hook;
+    int id;
+};
+
+struct CheckJobKey {
+    const int& operator()(const CheckJob& job) const {
+        return job.key;
+    }
+};
+
+typedef IntrusiveHollowHeap<CheckJob, int, &CheckJob::hook, CheckJobKey> IntrusiveHeap;
+
+/**
+ * IntrusiveChecker - runs random operations on an intrusive hollow heap and
+ *                    on a std::multiset of (key, id) pairs side by side
+ *
+ * The jobs live in one fixed pool, so they stay put while they're in the
+ * heap. A job that leaves the heap has its hook scribbled over, so the
+ * heap touching it again shows up as a crash or a mismatch.
+ */
+struct IntrusiveChecker {
+    const char* name;
+    int seed;
+    int op;
+    bool failed;
+
+    IntrusiveHeap heap;
+    std::multiset<std::pair<int, int>> model;
+
+    // The job pool, the ids of the jobs in the heap and of the rest, and
+    // each job's position in its list.
+    std::vector<CheckJob> jobs;
+    std::vector<int> live;
+    std::vector<int> spare;
+    std::vector<int> pos;
+
+    IntrusiveChecker(const char* _name, int _seed, int pool) : name(_name), seed(_seed), op(0), failed(false) {
+        jobs.resize(pool);
+        pos.resize(pool);
+        for (int id = 0; id < pool; id++) {
+            jobs[id].id = id;
+            pos[id] = spare.size();
+            spare.push_back(id);
+        }
+    }
+
+    bool check(bool ok, const char* what) {
+        if (!ok && !failed) {
+            fprintf(stderr, "incorrect: %s: %s (seed %d, op %d)\n", name, what, seed, op);
+            failed = true;
+        }
+        return ok;
+    }
+
+    // Moves job @id from one list to the end of the other.
+    void move(int id, std::vector<int>& from, std::vector<int>& to) {
+        from[pos[id]] = from.back();
+        pos[from.back()] = pos[id];
+        from.pop_back();
+        pos[id] = to.size();
+        to.push_back(id);
+    }
+
+    void removed(int id) {
+        model.erase(model.find(std::make_pair(jobs[id].key, id)));
+        move(id, live, spare);
+        memset(&jobs[id].hook, 0xa5, sizeof(jobs[id].hook));
+    }
+
+    void rekey(int id, int k) {
+        model.erase(model.find(std::make_pair(jobs[id].key, id)));
+        jobs[id].key = k;
+        model.insert(std::make_pair(k, id));
+        heap.decrease_key(jobs[id]);
+    }
+
+    int random_live() {
+        return live[rand() % live.size()];
+    }
+
+    void push() {
+        if (spare.empty())
+            return;
+        int id = spare[rand() % spare.size()];
+        jobs[id].key = rand() % 1000;
+        model.insert(std::make_pair(jobs[id].key, id));
+        move(id, spare, live);
+        heap.push(jobs[id]);
+    }
+
+    // Pops the minimum and checks it against the model.
+    void pop() {
+        if (!check(heap.empty() == model.empty(), "empty() disagrees"))
+            return;
+        if (heap.empty())
+            return;
+
+        CheckJob* job = heap.find_min();
+        heap.delete_min();
+
+        if (!check(job >= &jobs[0] && job < &jobs[0] + jobs.size(), "find_min returned a foreign object") ||
+            !check(job->key == model.begin()->first, "find_min is not the minimum") ||
+            !check(model.count(std::make_pair(job->key, job->id)) == 1, "find_min returned an object not in the heap"))
+            return;
+        removed(job->id);
+    }
+
+    void step() {
+        int r = rand() % 100;
+
+        if (r < 30)
+            push();
+        else if (r < 50) {
+            if (live.empty())
+                return;
+            int id = random_live();
+            rekey(id, jobs[id].key - rand() % 50);
+        }
+        else if (r < 60) {
+            if (live.empty())
+                return;
+            int id = random_live();
+            heap.erase(jobs[id]);
+            removed(id);
+        }
+        else if (r < 88)
+            pop();
+        else if (r < 90)
+            heap.rebuild();
+        else if (r < 91) {
+            if (live.empty())
+                return;
+
+            // Enough hollow nodes to make decrease_key rebuild on its own.
+            int n = 2 * live.size() + 1100;
+            for (int i = 0; i < n; i++) {
+                int id = random_live();
+                rekey(id, jobs[id].key - 1);
+            }
+        }
+        else if (r < 92 && rand() % 4 == 0) {
+            heap.clear();
+            while (!live.empty()) {
+                int id = live.back();
+                removed(id);
+            }
+        }
+        else
+            push();
+    }
+
+    bool run(int ops) {
+        srand(seed);
+        for (op = 0; op < ops && !failed; op++)
+            step();
+        while (!model.empty() && !failed)
+            pop();
+        check(heap.empty(), "heap not empty after draining");
+        return !failed;
+    }
+};
+
+bool check_intrusive(const char* name, int rounds, int ops) {
+    bool ok = true;
+    for (int seed = 0; seed < rounds && ok; seed++)
+        ok &= IntrusiveChecker(name, seed, 4096).run(ops);
+    return ok;
+}
+
+/**
+ * drain_matches - empties @h and checks that it held exactly @model
+ */
+template<class Heap>
+bool drain_matches(Heap& h, std::multiset<std::pair<int, int>>& model) {
+    while (!h.empty()) {
+        int k = *h.find_min_key();
+        int id = *h.find_min();
+        h.delete_min();
+
+        auto it = model.find(std::make_pair(k, id));
+        if (it == model.end() || k != model.begin()->first)
+            return false;
+        model.erase(it);
+    }
+    return model.empty();
+}
+
+/**
+ * check_overflow - runs push_range and decrease_key_range into the end of
+ *                  the index space
+ *
+ * Both throw partway through their batch. Whatever they did before that
+ * must be in the heap, and nothing else.
+ */
+template<class Heap>
+bool check_overflow(const char* name) {
+    typedef typename Heap::reference reference;
+    const int max = Heap::arena_type::max_index;
+    bool ok = true;
+
+    {
+        Heap h;
+        std::multiset<std::pair<int, int>> model;
+        int id = 0;
+        for (; id < max - 500; id++) {
+            h.push(id % 1000, id);
+            model.insert(std::make_pair(id % 1000, id));
+        }
+
+        std::vector<std::pair<int, int>> batch;
+        std::vector<reference> handles;
+        for (int i = 0; i < 1000; i++)
+            batch.push_back(std::make_pair(rand() % 1000, id + i));
+
+        bool threw = false;
+        try {
+            h.push_range(batch.begin(), batch.end(), std::back_inserter(handles));
+        }
+        catch (std::length_error&) {
+            threw = true;
+        }
+
+        for (size_t i = 0; i < handles.size(); i++) {
+            model.insert(batch[i]);
+            ok &= h.key(handles[i]) == batch[i].first && h.item(handles[i]) == batch[i].second;
+        }
+        ok &= threw && handles.size() == 500 && h.stats().nodes_full == (size_t) max;
+        ok &= drain_matches(h, model);
+        if (!ok)
+            fprintf(stderr, "incorrect: %s: push_range lost elements at the index limit\n", name);
+    }
+
+    {
+        Heap h;
+        std::multiset<std::pair<int, int>> model;
+        std::vector<reference> handles;
+        for (int id = 0; id < 60000; id++) {
+            handles.push_back(h.push(id % 1000 + 1000, id));
+            model.insert(std::make_pair(id % 1000 + 1000, id));
+        }
+
+        std::vector<std::pair<reference, int>> batch;
+        std::vector<reference> done;
+        for (int id = 0; id < 10000; id++)
+            batch.push_back(std::make_pair(handles[id], id % 1000));
+
+        bool threw = false;
+        try {
+            h.decrease_key_range(batch.begin(), batch.end(), std::back_inserter(done));
+        }
+        catch (std::length_error&) {
+            threw = true;
+        }
+
+        for (size_t i = 0; i < done.size(); i++) {
+            int id = h.item(done[i]);
+            model.erase(model.find(std::make_pair(id % 1000 + 1000, id)));
+            model.insert(std::make_pair(id % 1000, id));
+        }
+        ok &= threw && done.size() < batch.size();
+        ok &= drain_matches(h, model);
+        if (!ok)
+            fprintf(stderr, "incorrect: %s: decrease_key_range lost elements at the index limit\n", name);
+    }
+
+    return ok;
+}
+
+/**
+ * Checks HollowHeap against std::multiset under random pushes, range
+ * pushes, decrease-keys, range decrease-keys, erases, increase-keys,
+ * delete-mins, melds, rebuilds, compactions and clears, for each policy
+ * and index type, with a small delete budget and with std::string keys
+ * and items, inline or not, and the range operations
+ * running out of 16-bit indices. Checks IntrusiveHollowHeap the same way
+ * under pushes, decrease-keys, erases, delete-mins, rebuilds and clears.
+ * Exits with 1 on the first mismatch.
+ */
+int main(int argc, char* argv[]) {
+    int rounds = 100;
+    int ops = 4000;
+
+    if (argc > 1)
+        sscanf(argv[1], "%d", &rounds);
+    if (argc > 2)
+        sscanf(argv[2], "%d", &ops);
+
+    printf("rounds=%d ops=%d ", rounds, ops);
+
+    bool ok = true;
+    ok &= check_heap<DefaultHeap>("hhb", rounds, ops);
+    ok &= check_heap<PrefetchHeap>("hhpb", rounds, ops);
+    ok &= check_heap<MultiRootHeap>("hhmb", rounds, ops);
+    ok &= check_heap<InlineHeap>("hhib", rounds, ops);
+    ok &= check_heap<SmallIndexHeap>("hh16b", rounds, ops);
+    ok &= check_heap<DefaultHeap>("hhb_budget", rounds, ops, 4);
+    ok &= check_heap<MultiRootHeap>("hhmb_budget", rounds, ops, 4);
+    ok &= check_heap<StringHeap>("hhsb", rounds, ops);
+    ok &= check_heap<InlineStringHeap>("hhisb", rounds, ops);
+    ok &= check_overflow<SmallIndexHeap>("hh16b");
+    ok &= check_overflow<SmallMultiRootHeap>("hh16mb");
+    ok &= check_intrusive("hhi", rounds, ops);
+
+    printf("\n");
+
+    if (!ok)
+        return 1;
+
+    fprintf(stderr, "correct!\n");
+    return 0;
+}
@@ -0,0 +1,114 @@
+#ifndef _COMMON_H_
+#define _COMMON_H_
+
+#include <chrono>
+#include <vector>
+#include <utility>
+
+#include "graphs.h"
+
+/**
+ * now - returns a wall clock time in microseconds, for timing whole runs
+ *
+ * For single operations use ticks() from histogram.h.
+ */
+inline long long int now() {
+    auto t = std::chrono::high_resolution_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(t).count();
+}
+
+/**
+ * query - a short-lived heap's worth of work: k pushes, k/2 decrease-keys
+ *         and a full drain
+ *
+ * @h:    an empty heap
+ * @keys: the k keys to push; the items are their positions
+ * @refs: room for k handles
+ *
+ * Returns the sum of the items in the order they came out, so the work
+ * can't be optimized away and runs can be compared.
+ */
+template<class Heap>
+long long int query(Heap& h, const std::vector<int>& keys, std::vector<typename Heap::reference>& refs) {
+    int k = keys.size();
+    for (int i = 0; i < k; i++)
+        refs[i] = h.push(keys[i], i);
+    for (int i = 0; i < k/2; i++)
+        h.decrease_key(refs[i], keys[i] - k);
+
+    long long int sum = 0;
+    while (!h.empty()) {
+        sum += *h.find_min();
+        h.delete_min();
+    }
+    return sum;
+}
+
+/**
+ * dijkstra - computes shortest path distances from vertex 0 with one heap
+ *
+ * @g:       the graph
+ * @dist:    receives the distances
+ * @batched: relax the out-edges of a vertex with one decrease_key_range
+ *           instead of one decrease_key per edge
+ *
+ * Returns the time spent in microseconds.
+ */
+template<class Heap>
+long long int dijkstra(Graph* g, std::vector<int>& dist, bool batched = false) {
+    std::vector<int> done(g->N, 0);
+    std::vector<int> batch_pos(g->N, -1);
+    std::vector<typename Heap::reference> node_map(g->N);
+    std::vector<std::pair<typename Heap::reference, int>> batch;
+    std::vector<int> batch_vertices;
+
+    dist.assign(g->N, 1e9);
+    dist[0] = 0;
+
+    Heap h;
+    long long int pre_compute = now();
+    node_map[0] = h.push(0, 0);
+    for (int i = 1; i < g->N; i++)
+        node_map[i] = h.push(1e9, i);
+
+    while (!h.empty()) {
+        int u = *h.find_min();
+        int d = dist[u];
+
+        h.delete_min();
+        done[u] = 1;
+
+        batch.clear();
+        batch_vertices.clear();
+        for (int i = 0; i < g->vertices[u].out_edges.size(); i++) {
+            std::pair<int, int> vw = g->vertices[u].out_edges[i];
+            int v = vw.first;
+            int w = vw.second;
+
+            if (done[v] || d+w >= dist[v])
+                continue;
+
+            dist[v] = d+w;
+            if (!batched)
+                h.decrease_key(node_map[v], dist[v]);
+            else if (batch_pos[v] >= 0)  // parallel edge, same vertex
+                batch[batch_pos[v]].second = dist[v];
+            else {
+                batch_pos[v] = batch.size();
+                batch.push_back(std::make_pair(node_map[v], dist[v]));
+                batch_vertices.push_back(v);
+            }
+        }
+
+        if (batched) {
+            h.decrease_key_range(batch.begin(), batch.end());
+            for (int i = 0; i < batch_vertices.size(); i++)
+                batch_pos[batch_vertices[i]] = -1;
+        }
+    }
+    long long int post_compute = now();
+
+    return post_compute - pre_compute;
+}
+
+#endif
@@ -18,6 +18,7 @@ long long Benchmark<Heap>::compression(int N, int* freq_table) {
 
     log("computing the Huffman tree\n");
     long long int pre_compute = elapsed();
+    start_counters();
 
     Heap h;
     std::vector<huffman_node> nodes;
@@ -25,23 +26,24 @@ long long Benchmark<Heap>::compression(int N, int* freq_table) {
     for (int i = 0; i < N; i++) {
         if (freq_table[i] > 0) {
             nodes.push_back(huffman_node {freq_table[i], i, -1, -1});
-            h.push(freq_table[i], nodes.size()-1);
+            push(h, freq_table[i], nodes.size()-1);
             heap_size++;
         }
     }
 
     while (heap_size > 1) {
         int l1 = *h.find_min();
-        h.delete_min();
+        delete_min(h);
 
         int l2 = *h.find_min();
-        h.delete_min();
+        delete_min(h);
 
         nodes.push_back(huffman_node {nodes[l1].freq+nodes[l2].freq, -1, l1, l2});
-        h.push(nodes[l1].freq+nodes[l2].freq, nodes.size()-1);
+        push(h, nodes[l1].freq+nodes[l2].freq, nodes.size()-1);
         heap_size--;
     }
 
+    stop_counters();
     long long int post_compute = elapsed();
     log("elapsed = %lld us\n", post_compute - pre_compute);
 
@@ -24,15 +24,16 @@ long long Benchmark<Heap>::dijkstra(Graph* g) {
 
     Heap h;
     long long int pre_compute = elapsed();
-    node_map[0] = h.push(0, 0);
+    start_counters();
+    node_map[0] = push(h, 0, 0);
     for (int i = 1; i < g->N; i++)
-        node_map[i] = h.push(1e9, i);
+        node_map[i] = push(h, 1e9, i);
 
     while (!h.empty()) {
         int u = *h.find_min();
         int d = dist[u];
 
-        h.delete_min();
+        delete_min(h);
 
         for (int i = 0; i < g->vertices[u].out_edges.size(); i++) {
             std::pair<int, int> vw = g->vertices[u].out_edges[i];
@@ -42,11 +43,12 @@ long long Benchmark<Heap>::dijkstra(Graph* g) {
             if (in_tree[v] == 0 && d+w < dist[v]) {
                 dist[v] = d+w;
                 in_tree[v] = 1;
-                node_map[v] = h.decrease_key(node_map[v], dist[v]);
+                node_map[v] = decrease_key(h, node_map[v], dist[v]);
                 parent[v] = u;
             }
         }
     }
+    stop_counters();
     long long int post_compute = elapsed();
     log("elapsed = %lld us\n", post_compute - pre_compute);
 
@@ -0,0 +1,80 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "common.h"
+#include "../src/hollow_heap.hpp"
+
+typedef HollowHeap<int, std::string> Heap;
+
+/**
+ * fill - pushes one item per key, built from @payload, then drains the heap
+ *
+ * @mode: 0 copies the item in, 1 moves it in and 2 constructs it in place
+ *
+ * Prints the time taken by the pushes alone.
+ */
+long long int fill(const char* name, int mode, const std::vector<int>& keys, const std::string& payload) {
+    Heap h;
+    long long int pre = now();
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (mode == 0) {
+            std::string item(payload);
+            h.push(keys[i], item);
+        }
+        else if (mode == 1) {
+            std::string item(payload);
+            h.push(int(keys[i]), std::move(item));
+        }
+        else
+            h.emplace(keys[i], payload);
+    }
+    long long int post = now();
+    printf("%s_push=%lld ", name, post - pre);
+
+    long long int sum = 0;
+    while (!h.empty()) {
+        sum += h.find_min()->size();
+        h.delete_min();
+    }
+    return sum;
+}
+
+/**
+ * Pushes n std::string items of a given length into a heap by copy, by
+ * move and by emplace, and drains it again. Items too long for the small
+ * string buffer make a copy cost an allocation that a move doesn't.
+ */
+int main(int argc, char* argv[]) {
+    int seed = 0;
+    int n = 1 << 20;
+    int length = 64;
+
+    if (argc > 1)
+        sscanf(argv[1], "%d", &n);
+    if (argc > 2)
+        sscanf(argv[2], "%d", &length);
+
+    srand(seed);
+    std::vector<int> keys(n);
+    for (int i = 0; i < n; i++)
+        keys[i] = rand();
+    std::string payload(length, 'x');
+
+    printf("n=%d length=%d ", n, length);
+
+    const char* names[] = { "hhb_copy", "hhb_move", "hhb_emplace" };
+    long long int check[3];
+    for (int mode = 0; mode < 3; mode++)
+        check[mode] = fill(names[mode], mode, keys, payload);
+
+    if (check[0] != check[1] || check[0] != check[2])
+        fprintf(stderr, "incorrect: the runs differ\n");
+    else
+        fprintf(stderr, "correct!\n");
+
+    printf("\n");
+
+    return 0;
+}
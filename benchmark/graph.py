@@ -14,6 +14,8 @@ bar_width = 0.2
 
 heaps = {
     "hhb":  ("s", "Hollow Heap (Optimized)", "hhb\\_opt"),
+    "hhpb": ("D", "Hollow Heap (Prefetch)", "hhb\\_pf"),
+    "hhmb": ("P", "Hollow Heap (Multi-root)", "hhb\\_mr"),
     "uhhb": ("o", "Hollow Heap (Direct)", "hhb\\_dir"),
     "fhb":  ("v", "Fibonacci Heap", "fhb"),
     "phb":  ("^", "Pairing Heap", "phb"),
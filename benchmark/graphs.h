@@ -53,6 +53,40 @@ public:
             }
         }
     }
+
+    /**
+     * generate_grid - connects the N vertices as a @side by @side grid, each
+     *                 to its four neighbours, with vertex ids shuffled so
+     *                 that neighbours aren't adjacent in memory
+     *
+     * @side: the grid's width and height, with N = side * side
+     * @seed: the seed for the shuffle and the weights
+     */
+    void generate_grid(int side, int seed) {
+        srand(seed);
+
+        std::vector<int> id(N);
+        for (int i = 0; i < N; i++)
+            id[i] = i;
+        for (int i = N-1; i > 0; i--)
+            std::swap(id[i], id[rand() % (i+1)]);
+
+        for (int r = 0; r < side; r++) {
+            for (int c = 0; c < side; c++) {
+                int u = id[r*side + c];
+                if (c+1 < side) {
+                    int w = 1 + (rand()%100);
+                    vertices[u].add_edge(id[r*side + c+1], w);
+                    vertices[id[r*side + c+1]].add_edge(u, w);
+                }
+                if (r+1 < side) {
+                    int w = 1 + (rand()%100);
+                    vertices[u].add_edge(id[(r+1)*side + c], w);
+                    vertices[id[(r+1)*side + c]].add_edge(u, w);
+                }
+            }
+        }
+    }
 };
 
 #endif  // _GRAPH_H_
@@ -0,0 +1,131 @@
+#ifndef _HISTOGRAM_H_
+#define _HISTOGRAM_H_
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * ticks - reads a cheap, monotonic tick counter
+ *
+ * The TSC on x86, so that timing a single heap operation costs a few
+ * cycles instead of a clock_gettime call; steady_clock nanoseconds
+ * elsewhere. rdtsc isn't serializing, which is fine for operations that
+ * take tens of cycles or more.
+ */
+inline uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    auto t = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t).count();
+#endif
+}
+
+/**
+ * ticks_per_ns - returns the rate of ticks(), calibrated on first use
+ */
+inline double ticks_per_ns() {
+    static double rate = 0;
+
+    if (rate == 0) {
+        auto pre_time = std::chrono::steady_clock::now();
+        uint64_t pre_ticks = ticks();
+        while (std::chrono::steady_clock::now() - pre_time < std::chrono::milliseconds(20))
+            ;
+        auto post_time = std::chrono::steady_clock::now();
+        uint64_t post_ticks = ticks();
+
+        long long int ns = std::chrono::duration_cast<std::chrono::nanoseconds>(post_time - pre_time).count();
+        rate = (double) (post_ticks - pre_ticks) / ns;
+    }
+
+    return rate;
+}
+
+/**
+ * Histogram - a log-linear histogram of tick counts, as in HdrHistogram
+ *
+ * Values below 32 get a bucket each; above that every power of two is split
+ * into 32 buckets, so a percentile is off by at most 1/32 of its value. That
+ * takes 1920 counters to cover all of uint64_t and makes record() a clz and
+ * an increment.
+ */
+class Histogram {
+    static const int sub_bits = 5;
+    static const int sub_count = 1 << sub_bits;
+    static const int num_buckets = (64 - sub_bits + 1) * sub_count;
+
+    uint64_t counts[num_buckets];
+    uint64_t total;
+    uint64_t max_value;
+
+    static int bucket(uint64_t v) {
+        if (v < sub_count)
+            return v;
+
+        int shift = 63 - __builtin_clzll(v) - sub_bits;
+        return (shift+1) * sub_count + (int) ((v >> shift) - sub_count);
+    }
+
+    // The largest value that falls into bucket i.
+    static uint64_t bucket_max(int i) {
+        if (i < sub_count)
+            return i;
+
+        int shift = i / sub_count - 1;
+        uint64_t low = (uint64_t) (sub_count + i % sub_count) << shift;
+        return low + ((uint64_t) 1 << shift) - 1;
+    }
+
+public:
+    Histogram() {
+        reset();
+    }
+
+    void reset() {
+        memset(counts, 0, sizeof(counts));
+        total = 0;
+        max_value = 0;
+    }
+
+    void record(uint64_t v) {
+        counts[bucket(v)]++;
+        total++;
+        if (v > max_value)
+            max_value = v;
+    }
+
+    uint64_t count() const {
+        return total;
+    }
+
+    uint64_t max() const {
+        return max_value;
+    }
+
+    /**
+     * percentile - returns the value that a fraction @p of records are at
+     *              or below, rounded up to its bucket's upper bound
+     */
+    uint64_t percentile(double p) const {
+        uint64_t target = p * total;
+        if (target < 1)
+            target = 1;
+
+        uint64_t seen = 0;
+        for (int i = 0; i < num_buckets; i++) {
+            seen += counts[i];
+            if (seen >= target)
+                return bucket_max(i) < max_value ? bucket_max(i) : max_value;
+        }
+
+        return max_value;
+    }
+};
+
+#endif  // _HISTOGRAM_H_
@@ -0,0 +1,290 @@
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+#include <utility>
+
+#include "common.h"
+#include "graphs.h"
+#include "argument.h"
+#include "../src/hollow_heap.hpp"
+
+typedef HollowHeap<int, int> Heap;
+
+/**
+ * A vertex's state within one query, valid only if @epoch is the query's.
+ * Keeping it in one record makes it a single cache miss.
+ */
+struct Visit {
+    unsigned epoch;
+    int dist;
+    Heap::reference ref;
+    int done;
+};
+
+/**
+ * Search - a point-to-point Dijkstra query that can be run a step at a time
+ *
+ * Every settled vertex takes four steps, each ending at the memory that
+ * the next one will touch: the vertex, its out-edges and its neighbours'
+ * visits. The prefetch issued at the end of a step has the other queries'
+ * steps to complete in. The heap and the visits are reused from query to
+ * query; bumping the epoch forgets the previous one.
+ */
+struct Search {
+    enum { POP, EDGES, VISITS, RELAX };
+
+    Graph* g;
+    Heap heap;
+    std::vector<Visit> visits;
+    unsigned epoch;
+
+    int target;
+    int result;
+
+    int stage;
+    Node* node;
+    int d;
+
+    Search(Graph* _g) : g(_g), visits(_g->N), epoch(0) {
+        for (int i = 0; i < g->N; i++)
+            visits[i].epoch = 0;
+    }
+
+    void reach(int v, int dist) {
+        Visit& x = visits[v];
+        if (x.epoch != epoch) {
+            x.epoch = epoch;
+            x.dist = dist;
+            x.done = 0;
+            x.ref = heap.push(dist, v);
+        }
+        else if (!x.done && dist < x.dist) {
+            x.dist = dist;
+            heap.decrease_key(x.ref, dist);
+        }
+    }
+
+    void start(int source, int _target) {
+        epoch++;
+        heap.clear();
+        target = _target;
+        stage = POP;
+        reach(source, 0);
+    }
+
+    /**
+     * step - advances the query by one step
+     *
+     * Returns true once @result holds the distance to the target, 1e9 if
+     * it can't be reached.
+     */
+    bool step() {
+        switch (stage) {
+        case POP: {
+            if (heap.empty()) {
+                result = 1e9;
+                return true;
+            }
+
+            int u = *heap.find_min();
+            d = visits[u].dist;
+            heap.delete_min();
+            visits[u].done = 1;
+
+            if (u == target) {
+                result = d;
+                return true;
+            }
+
+            node = &g->vertices[u];
+            __builtin_prefetch(node);
+            stage = EDGES;
+            return false;
+        }
+
+        case EDGES:
+            __builtin_prefetch(node->out_edges.data());
+            stage = VISITS;
+            return false;
+
+        case VISITS:
+            for (int i = 0; i < node->out_edges.size(); i++)
+                __builtin_prefetch(&visits[node->out_edges[i].first]);
+            stage = RELAX;
+            return false;
+
+        default:
+            for (int i = 0; i < node->out_edges.size(); i++)
+                reach(node->out_edges[i].first, d + node->out_edges[i].second);
+            stage = POP;
+            return false;
+        }
+    }
+
+    /**
+     * run - runs a query to completion with no prefetching, as a plain
+     *       Dijkstra loop would
+     */
+    int run(int source, int _target) {
+        start(source, _target);
+
+        while (!heap.empty()) {
+            int u = *heap.find_min();
+            int d = visits[u].dist;
+            heap.delete_min();
+            visits[u].done = 1;
+
+            if (u == target)
+                return d;
+
+            Node& n = g->vertices[u];
+            for (int i = 0; i < n.out_edges.size(); i++)
+                reach(n.out_edges[i].first, d + n.out_edges[i].second);
+        }
+
+        return 1e9;
+    }
+};
+
+/**
+ * serial - answers the queries one after another
+ *
+ * Returns the time spent in microseconds.
+ */
+long long int serial(Graph* g, const std::vector<std::pair<int, int>>& queries, std::vector<int>& results) {
+    Search s(g);
+
+    long long int pre = now();
+    for (size_t q = 0; q < queries.size(); q++)
+        results[q] = s.run(queries[q].first, queries[q].second);
+    long long int post = now();
+
+    return post - pre;
+}
+
+/**
+ * interleaved - answers the queries @k at a time, taking one step of each
+ *               in turn and starting the next query in a slot that finishes
+ *
+ * Returns the time spent in microseconds.
+ */
+long long int interleaved(Graph* g, const std::vector<std::pair<int, int>>& queries, std::vector<int>& results, int k) {
+    std::vector<Search*> slots(k);
+    std::vector<size_t> query_of(k);
+    for (int i = 0; i < k; i++)
+        slots[i] = new Search(g);
+
+    long long int pre = now();
+    size_t next = 0;
+    int running = 0;
+    for (int i = 0; i < k && next < queries.size(); i++, next++, running++) {
+        query_of[i] = next;
+        slots[i]->start(queries[next].first, queries[next].second);
+    }
+
+    while (running > 0) {
+        for (int i = 0; i < running; i++) {
+            if (!slots[i]->step())
+                continue;
+
+            results[query_of[i]] = slots[i]->result;
+            if (next < queries.size()) {
+                query_of[i] = next;
+                slots[i]->start(queries[next].first, queries[next].second);
+                next++;
+            }
+            else {
+                // Keep the running slots at the front.
+                running--;
+                std::swap(slots[i], slots[running]);
+                std::swap(query_of[i], query_of[running]);
+                i--;
+            }
+        }
+    }
+    long long int post = now();
+
+    for (int i = 0; i < k; i++)
+        delete slots[i];
+
+    return post - pre;
+}
+
+void run(const char* name, Graph* g, int num_queries, int max_k) {
+    std::vector<std::pair<int, int>> queries(num_queries);
+    for (int q = 0; q < num_queries; q++)
+        queries[q] = std::make_pair(rand() % g->N, rand() % g->N);
+
+    std::vector<int> serial_results(num_queries), results(num_queries);
+    long long int serial_time = serial(g, queries, serial_results);
+    printf("hhb_%s_serial_qps=%.1f ", name, num_queries * 1e6 / serial_time);
+
+    for (int k = 2; k <= max_k; k *= 2) {
+        long long int time = interleaved(g, queries, results, k);
+        printf("hhb_%s_k%d_qps=%.1f ", name, k, num_queries * 1e6 / time);
+
+        if (results != serial_results)
+            fprintf(stderr, "incorrect: %s distances differ with k=%d\n", name, k);
+        else
+            fprintf(stderr, "correct!\n");
+    }
+}
+
+/**
+ * Answers random point-to-point queries one after another and k at a time
+ * with interleaved steps, for k = 2, 4, ..., on the random sparse and dense
+ * graphs for n (as all_tests does), or on the road graphs if n is 0. If a
+ * grid side is given, runs on a side x side grid with shuffled vertex ids
+ * instead, which can be made too big for the cache. Reports queries per
+ * second.
+ */
+int main(int argc, char* argv[]) {
+    int seed = 0;
+    int n = 1 << 16;
+    int num_queries = 1000;
+    int max_k = 16;
+    int side = 0;
+
+    if (argc > 1)
+        sscanf(argv[1], "%d", &n);
+    if (argc > 2)
+        sscanf(argv[2], "%d", &num_queries);
+    if (argc > 3)
+        sscanf(argv[3], "%d", &max_k);
+    if (argc > 4)
+        sscanf(argv[4], "%d", &side);
+
+    if (side > 0) {
+        printf("side=%d queries=%d ", side, num_queries);
+
+        fprintf(stderr, "generating grid_graph...\n");
+        Graph* grid = new Graph(side * side, 2LL * side * (side-1));
+        grid->generate_grid(side, seed);
+
+        srand(seed + 1);
+        run("grid", grid, num_queries, max_k);
+        printf("\n");
+
+        delete grid;
+        return 0;
+    }
+
+    printf("n=%d queries=%d ", n, num_queries);
+
+    argument* args = init_args(n, seed);
+
+    srand(seed + 1);
+    if (n == 0) {
+        run("nyc", args->nyc_graph, num_queries, max_k);
+        run("bay", args->bay_graph, num_queries, max_k);
+    }
+    else {
+        run("sparse", args->sparse_graph, num_queries, max_k);
+        run("dense", args->dense_graph, num_queries, max_k);
+    }
+
+    printf("\n");
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "common.h"
+#include "../src/hollow_heap.hpp"
+#include "../src/intrusive_hollow_heap.hpp"
+
+/**
+ * A scheduler's job: the key and, for the intrusive heap, the hook live
+ * in the job itself. The payload stands in for the rest of the job.
+ */
+struct Job {
+    int key;
+    HollowHeapHook hook;
+    HollowHeap<int, Job*>::reference ref;
+    char payload[40];
+};
+
+struct JobKey {
+    const int& operator()(const Job& job) const {
+        return job.key;
+    }
+};
+
+typedef HollowHeap<int, Job*> Heap;
+typedef IntrusiveHollowHeap<Job, int, &Job::hook, JobKey> IntrusiveHeap;
+
+/**
+ * Every step decreases the keys of a burst of random jobs, then runs the
+ * next job and requeues it behind its old key. Both heaps see the same
+ * sequence of operations.
+ */
+template<class Queue>
+long long int schedule(Queue& queue, std::vector<Job>& jobs, int steps, int burst) {
+    long long int check = 0;
+
+    for (size_t i = 0; i < jobs.size(); i++)
+        queue.push(jobs[i]);
+
+    for (int s = 0; s < steps; s++) {
+        for (int i = 0; i < burst; i++) {
+            Job& job = jobs[rand() % jobs.size()];
+            job.key -= rand() % 1024 + 1;
+            queue.decrease_key(job);
+        }
+
+        Job* job = queue.find_min();
+        check += job->key;
+        queue.delete_min();
+
+        job->key += rand() % (1 << 20);
+        queue.push(*job);
+    }
+
+    return check;
+}
+
+// The same interface over HollowHeap, with the handle kept in the job.
+struct HeapQueue {
+    Heap heap;
+
+    void push(Job& job) {
+        job.ref = heap.push(job.key, &job);
+    }
+
+    void decrease_key(Job& job) {
+        heap.decrease_key(job.ref, job.key);
+    }
+
+    Job* find_min() {
+        return *heap.find_min();
+    }
+
+    void delete_min() {
+        heap.delete_min();
+    }
+};
+
+int main(int argc, char* argv[]) {
+    int seed = 0;
+    int n = 1 << 20;
+    int steps = 1 << 18;
+    int burst = 16;
+
+    if (argc > 1)
+        sscanf(argv[1], "%d", &n);
+    if (argc > 2)
+        sscanf(argv[2], "%d", &steps);
+
+    std::vector<Job> jobs(n);
+    std::vector<int> keys(n);
+    srand(seed);
+    for (int i = 0; i < n; i++)
+        keys[i] = rand() % (1 << 30);
+
+    printf("n=%d steps=%d ", n, steps);
+
+    srand(seed + 1);
+    for (int i = 0; i < n; i++)
+        jobs[i].key = keys[i];
+    long long int check_heap;
+    long long int pre_heap = now();
+    {
+        HeapQueue queue;
+        check_heap = schedule(queue, jobs, steps, burst);
+    }
+    long long int post_heap = now();
+
+    srand(seed + 1);
+    for (int i = 0; i < n; i++)
+        jobs[i].key = keys[i];
+    long long int check_intrusive;
+    long long int pre_intrusive = now();
+    {
+        IntrusiveHeap queue;
+        check_intrusive = schedule(queue, jobs, steps, burst);
+    }
+    long long int post_intrusive = now();
+
+    printf("hhb=%lld hhb_intrusive=%lld ", post_heap - pre_heap, post_intrusive - pre_intrusive);
+
+    if (check_heap != check_intrusive)
+        fprintf(stderr, "incorrect: the runs differ\n");
+    else
+        fprintf(stderr, "correct!\n");
+
+    printf("\n");
+
+    return 0;
+}
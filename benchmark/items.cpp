@@ -0,0 +1,35 @@
+#include <cstdio>
+#include <cmath>
+
+#include "graphs.h"
+#include "argument.h"
+#include "benchmark.h"
+#include "payload.h"
+#include "../src/hollow_heap.hpp"
+
+int main(int argc, char* argv[]) {
+    int seed = 0;
+    int n = 101;
+
+    if (argc > 1) {
+        sscanf(argv[1], "%d", &n);
+    }
+
+    printf("n=%d ", n);
+
+    int benchmarks = SORT               |
+                     DIJKSTRA           |
+                     PRIM               |
+                     0;
+
+    argument* args = init_args(n, seed);
+
+    Benchmark<HollowHeap<int, int>>("hhb4").run(benchmarks, args);
+    Benchmark<HollowHeap<int, payload<16>>>("hhb16").run(benchmarks, args);
+    Benchmark<HollowHeap<int, payload<48>>>("hhb48").run(benchmarks, args);
+    Benchmark<HollowHeap<int, payload<128>>>("hhb128").run(benchmarks, args);
+
+    printf("\n");
+
+    return 0;
+}
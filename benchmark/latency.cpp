@@ -0,0 +1,122 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "histogram.h"
+#include "../src/hollow_heap.hpp"
+
+typedef HollowHeap<int, int, std::less<int>, unsigned, hh_stats_policy> Heap;
+
+/**
+ * report - prints the median and tail of a set of latencies, taken in
+ *          ticks, in ns
+ */
+void report(const char* name, std::vector<uint64_t>& lat) {
+    std::sort(lat.begin(), lat.end());
+
+    size_t n = lat.size();
+    double rate = ticks_per_ns();
+    printf("%s_p50=%lld %s_p99=%lld %s_p999=%lld %s_max=%lld ",
+           name, (long long) (lat[n/2] / rate), name, (long long) (lat[n*99/100] / rate),
+           name, (long long) (lat[n*999/1000] / rate), name, (long long) (lat[n-1] / rate));
+}
+
+/**
+ * report_stats - prints the heap's counters, which account for the outliers:
+ *                every rebuild is one O(n) decrease_key
+ */
+void report_stats(const char* name, const HollowHeapStats& s) {
+    printf("%s_links=%llu %s_eqlinks=%llu %s_ranked=%llu %s_inserts=%llu %s_decs=%llu %s_rebuilds=%llu ",
+           name, (unsigned long long) s.links, name, (unsigned long long) s.eqlinks,
+           name, (unsigned long long) s.ranked, name, (unsigned long long) s.inserts,
+           name, (unsigned long long) s.decs, name, (unsigned long long) s.rebuilds);
+    printf("%s_nodes_full=%zu %s_nodes_hollow=%zu %s_arena_bytes=%zu %s_max_rank=%u %s_to_delete_peak=%zu ",
+           name, s.nodes_full, name, s.nodes_hollow, name, s.arena_bytes,
+           name, s.max_rank, name, s.to_delete_peak);
+}
+
+/**
+ * Simulates a scheduler queue: a heap of n tasks in which every step runs
+ * a burst of decrease_keys on random tasks, then pops the next task and
+ * queues a new one behind it. Every operation is timed on its own, and
+ * the heap keeps hh_stats_policy counters, printed at the end. A nonzero
+ * budget is set with set_delete_budget.
+ */
+int main(int argc, char* argv[]) {
+    int seed = 0;
+    int n = 1 << 18;
+    int steps = 1 << 16;
+    int burst = 64;
+    int budget = 0;
+
+    if (argc > 1)
+        sscanf(argv[1], "%d", &n);
+    if (argc > 2)
+        sscanf(argv[2], "%d", &steps);
+    if (argc > 3)
+        sscanf(argv[3], "%d", &budget);
+
+    srand(seed);
+
+    Heap h;
+    h.set_delete_budget(budget);
+
+    std::vector<Heap::reference> refs;
+    std::vector<int> keys;
+    std::vector<int> live;
+    std::vector<int> pos;
+    for (int i = 0; i < n; i++) {
+        keys.push_back(rand() % (1 << 30));
+        refs.push_back(h.push(keys[i], i));
+        live.push_back(i);
+        pos.push_back(i);
+    }
+
+    std::vector<uint64_t> dec_lat, del_lat, push_lat;
+    uint64_t pre, post;
+
+    for (int s = 0; s < steps; s++) {
+        for (int i = 0; i < burst; i++) {
+            int id = live[rand() % live.size()];
+            keys[id] -= rand() % 1024 + 1;
+
+            pre = ticks();
+            h.decrease_key(refs[id], keys[id]);
+            post = ticks();
+            dec_lat.push_back(post - pre);
+        }
+
+        int id = *h.find_min();
+        int key = keys[id];
+
+        pre = ticks();
+        h.delete_min();
+        post = ticks();
+        del_lat.push_back(post - pre);
+
+        live[pos[id]] = live.back();
+        pos[live.back()] = pos[id];
+        live.pop_back();
+
+        int nid = keys.size();
+        keys.push_back(key + rand() % (1 << 20));
+        pos.push_back(live.size());
+        live.push_back(nid);
+
+        pre = ticks();
+        refs.push_back(h.push(keys[nid], nid));
+        post = ticks();
+        push_lat.push_back(post - pre);
+    }
+
+    printf("n=%d steps=%d budget=%d ", n, steps, budget);
+    report("hhb_decrease_key", dec_lat);
+    report("hhb_delete_min", del_lat);
+    report("hhb_push", push_lat);
+    report_stats("hhb", h.stats());
+    printf("\n");
+
+    return 0;
+}
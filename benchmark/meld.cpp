@@ -0,0 +1,98 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "common.h"
+#include "../src/hollow_heap.hpp"
+
+typedef HollowHeap<int, int> Heap;
+
+/**
+ * drain - empties a heap and returns its items in order
+ */
+std::vector<int> drain(Heap& h) {
+    std::vector<int> result;
+    while (!h.empty()) {
+        result.push_back(*h.find_min());
+        h.delete_min();
+    }
+    return result;
+}
+
+/**
+ * Merges a number of shards holding n random ints between them into one
+ * heap, once with meld on a shared arena and once by draining every shard
+ * and pushing its elements into the target. Only the merge is timed.
+ */
+int main(int argc, char* argv[]) {
+    int seed = 0;
+    int n = 1 << 20;
+    int shards = 64;
+
+    if (argc > 1)
+        sscanf(argv[1], "%d", &n);
+    if (argc > 2)
+        sscanf(argv[2], "%d", &shards);
+
+    printf("n=%d shards=%d ", n, shards);
+
+    srand(seed);
+    std::vector<int> nums(n);
+    for (int i = 0; i < n; i++)
+        nums[i] = rand() % n;
+
+    Heap::arena_type arena;
+    Heap melded(arena);
+    std::vector<Heap*> meld_shards;
+    for (int s = 0; s < shards; s++)
+        meld_shards.push_back(new Heap(arena));
+
+    Heap reinserted;
+    std::vector<Heap*> reinsert_shards;
+    for (int s = 0; s < shards; s++)
+        reinsert_shards.push_back(new Heap);
+
+    for (int i = 0; i < n; i++) {
+        meld_shards[i % shards]->push(nums[i], nums[i]);
+        reinsert_shards[i % shards]->push(nums[i], nums[i]);
+    }
+
+    // Give the shards some structure beyond a single root with n/shards
+    // children, as a long-running work queue would have.
+    for (int s = 0; s < shards; s++) {
+        meld_shards[s]->delete_min();
+        reinsert_shards[s]->delete_min();
+    }
+
+    long long int pre_meld = now();
+    for (int s = 0; s < shards; s++)
+        melded.meld(*meld_shards[s]);
+    long long int post_meld = now();
+
+    long long int pre_reinsert = now();
+    for (int s = 0; s < shards; s++) {
+        Heap* h = reinsert_shards[s];
+        while (!h->empty()) {
+            int x = *h->find_min();
+            h->delete_min();
+            reinserted.push(x, x);
+        }
+    }
+    long long int post_reinsert = now();
+
+    printf("hhb_meld=%lld hhb_reinsert=%lld ", post_meld - pre_meld, post_reinsert - pre_reinsert);
+
+    if (drain(melded) != drain(reinserted))
+        fprintf(stderr, "incorrect: melded and reinserted heaps differ\n");
+    else
+        fprintf(stderr, "correct!\n");
+
+    for (int s = 0; s < shards; s++) {
+        delete meld_shards[s];
+        delete reinsert_shards[s];
+    }
+
+    printf("\n");
+
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+#include "histogram.h"
+#include "../src/hollow_heap.hpp"
+#include "../src/hollow_multi_queue.hpp"
+
+typedef HollowMultiQueue<int, uint64_t> MultiQueue;
+
+const int key_bits = 20;
+bool lost = false;
+
+// The exact baseline: one HollowHeap behind a mutex, with the same interface.
+struct MutexQueue {
+    typedef HollowHeap<int, uint64_t> Heap;
+    typedef Heap::reference handle;
+
+    std::mutex lock;
+    Heap heap;
+
+    MutexQueue(size_t) {
+    }
+
+    handle push(int key, uint64_t item) {
+        std::lock_guard<std::mutex> guard(lock);
+        return heap.push(key, item);
+    }
+
+    bool try_pop(int& key, uint64_t& item) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (heap.empty())
+            return false;
+        key = *heap.find_min_key();
+        item = *heap.find_min();
+        heap.delete_min();
+        return true;
+    }
+
+    bool decrease_key(handle h, int new_key, uint64_t item) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!heap.contains(h) || heap.item(h) != item)
+            return false;
+        if (new_key < heap.key(h))
+            heap.decrease_key(h, new_key);
+        return true;
+    }
+};
+
+/**
+ * One operation as seen by the thread that did it. Pushes and decreases
+ * are stamped before they start and pops after they finish, so that an
+ * element is always in the replay when it's popped.
+ */
+struct Event {
+    uint64_t time;
+    int type; // 0 push, 1 pop, 2 decrease
+    int key;
+    int old_key;
+};
+
+// Counts of present keys, for the number of keys below a popped one.
+struct Fenwick {
+    std::vector<int> tree;
+
+    Fenwick() : tree((1 << key_bits) + 1) {
+    }
+
+    void add(int key, int delta) {
+        for (int i = key+1; i < (int) tree.size(); i += i & -i)
+            tree[i] += delta;
+    }
+
+    // The number of present keys smaller than @key.
+    long long int below(int key) {
+        long long int sum = 0;
+        for (int i = key; i > 0; i -= i & -i)
+            sum += tree[i];
+        return sum;
+    }
+};
+
+/**
+ * replay - merges the threads' logs by time and measures how many smaller
+ *          keys were in the queue at each pop
+ */
+void replay(std::vector<std::vector<Event>>& logs, double& mean, long long int& max) {
+    std::vector<Event> events;
+    for (size_t t = 0; t < logs.size(); t++)
+        events.insert(events.end(), logs[t].begin(), logs[t].end());
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Event& a, const Event& b) { return a.time < b.time; });
+
+    Fenwick present;
+    long long int total = 0, pops = 0;
+    max = 0;
+    for (size_t i = 0; i < events.size(); i++) {
+        Event& e = events[i];
+        if (e.type == 0)
+            present.add(e.key, 1);
+        else if (e.type == 1) {
+            long long int rank = present.below(e.key);
+            total += rank;
+            max = std::max(max, rank);
+            pops++;
+            present.add(e.key, -1);
+        }
+        else {
+            present.add(e.old_key, -1);
+            present.add(e.key, 1);
+        }
+    }
+
+    mean = pops ? double(total) / pops : 0;
+}
+
+struct Owned {
+    uint64_t item;
+    int key;
+};
+
+/**
+ * work - one thread's share: about 45% pushes, 45% pops and 10% decreases
+ *        of elements the thread pushed itself
+ */
+template<class Queue, class Handle>
+void work(Queue& queue, int id, int ops, std::vector<Event>& log, long long int& popped) {
+    const int window = 1024;
+    std::vector<Handle> handles(window);
+    std::vector<Owned> owned(window);
+    int pushed = 0;
+    uint64_t seed = (id + 1) * 0x9e3779b97f4a7c15ull;
+
+    log.reserve(ops);
+    for (int i = 0; i < ops; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        int r = seed % 100;
+        int key = (seed >> 8) % (1 << (key_bits-1)) + (1 << (key_bits-1));
+
+        if (r < 45) {
+            uint64_t item = (uint64_t(id) << 32) | pushed;
+            uint64_t time = ticks();
+            handles[pushed % window] = queue.push(key, item);
+            owned[pushed % window] = { item, key };
+            pushed++;
+            log.push_back({ time, 0, key, 0 });
+        }
+        else if (r < 90) {
+            uint64_t item;
+            if (queue.try_pop(key, item)) {
+                log.push_back({ ticks(), 1, key, 0 });
+                popped++;
+            }
+        }
+        else if (pushed) {
+            int j = (seed >> 40) % std::min(pushed, window);
+            int new_key = std::max(owned[j].key - int(seed >> 56) - 1, 0);
+            uint64_t time = ticks();
+            if (queue.decrease_key(handles[j], new_key, owned[j].item)) {
+                log.push_back({ time, 2, new_key, owned[j].key });
+                owned[j].key = new_key;
+            }
+        }
+    }
+}
+
+/**
+ * run - prefills a queue and runs the mix on @threads threads at once
+ *
+ * Prints the wall time, the throughput and the rank error of the pops.
+ */
+template<class Queue, class Handle>
+void run(const char* name, int threads, int ops, int prefill) {
+    Queue queue(threads);
+    std::vector<std::vector<Event>> logs(threads + 1);
+
+    srand(threads);
+    for (int i = 0; i < prefill; i++) {
+        int key = rand() % (1 << (key_bits-1)) + (1 << (key_bits-1));
+        queue.push(key, ~uint64_t(i));
+        logs[threads].push_back({ 0, 0, key, 0 });
+    }
+
+    std::atomic<int> ready(0);
+    std::vector<long long int> popped(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+        workers.emplace_back([&, t]() {
+            ready++;
+            while (ready.load() < threads)
+                std::this_thread::yield();
+            work<Queue, Handle>(queue, t, ops, logs[t], popped[t]);
+        });
+    while (ready.load() < threads)
+        std::this_thread::yield();
+    long long int pre = now();
+    for (int t = 0; t < threads; t++)
+        workers[t].join();
+    long long int post = now();
+
+    // Everything pushed and not popped must still be there.
+    long long int pushes = prefill, pops = 0, left = 0;
+    for (int t = 0; t < threads; t++) {
+        pops += popped[t];
+        for (size_t i = 0; i < logs[t].size(); i++)
+            pushes += logs[t][i].type == 0;
+    }
+    int key;
+    uint64_t item;
+    while (queue.try_pop(key, item))
+        left++;
+    if (pushes - pops != left)
+        lost = true;
+
+    double mean;
+    long long int max;
+    replay(logs, mean, max);
+
+    printf("%s=%lld %s_mops=%.2f %s_rank=%.2f %s_rank_max=%lld ",
+           name, post - pre, name, double(threads) * ops / (post - pre),
+           name, mean, name, max);
+}
+
+/**
+ * Runs the same mix of pushes, pops and decrease-keys on a MultiQueue of
+ * hollow heaps and on one hollow heap behind a mutex, with 1, 2, 4, ...
+ * threads. The rank error of a pop is the number of smaller keys in the
+ * queue at the time; it's zero for the exact queue up to clock skew.
+ */
+int main(int argc, char* argv[]) {
+    int max_threads = std::max(4u, std::thread::hardware_concurrency());
+    int ops = 1 << 20;
+    int prefill = 1 << 16;
+
+    if (argc > 1)
+        sscanf(argv[1], "%d", &max_threads);
+    if (argc > 2)
+        sscanf(argv[2], "%d", &ops);
+    if (argc > 3)
+        sscanf(argv[3], "%d", &prefill);
+
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        printf("threads=%d ops=%d ", threads, ops);
+        run<MultiQueue, MultiQueue::handle>("hhb_mq", threads, ops, prefill);
+        run<MutexQueue, MutexQueue::handle>("hhb_mutex", threads, ops, prefill);
+        printf("\n");
+    }
+
+    if (lost)
+        fprintf(stderr, "incorrect: elements were lost\n");
+    else
+        fprintf(stderr, "correct!\n");
+
+    return 0;
+}
@@ -0,0 +1,24 @@
+#ifndef _PAYLOAD_H_
+#define _PAYLOAD_H_
+
+/**
+ * An item of a given size that behaves like the int it carries, so that the
+ * existing benchmarks can be run with larger items than a plain int.
+ */
+template<int Bytes>
+struct payload {
+    int value;
+    char padding[Bytes - sizeof(int)];
+
+    payload() {}
+
+    payload(int _value) {
+        value = _value;
+    }
+
+    operator int() const {
+        return value;
+    }
+};
+
+#endif  // _PAYLOAD_H_
@@ -0,0 +1,175 @@
+#ifndef _PERF_COUNTERS_H_
+#define _PERF_COUNTERS_H_
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * PerfCounters - a group of hardware counters for this thread
+ *
+ * Opens cycles, instructions, L1D read misses, LLC misses, branch misses
+ * and dTLB read misses as one perf_event group so that they are scheduled
+ * onto the PMU together. Counts accumulate over every start()/stop() pair
+ * until print() reports and clears them.
+ *
+ * Events the CPU or kernel won't give us are left out; if not even cycles
+ * can be opened (no PMU in a VM, perf_event_paranoid too high, not Linux)
+ * available() is false and everything else is a no-op.
+ *
+ * If the PMU is shared (the NMI watchdog, other perf users) the group may
+ * only be scheduled for part of a start()/stop() interval. Its counts are
+ * then scaled up by time enabled over time running, as perf stat does. If
+ * it wasn't scheduled at all, print() says so instead of printing zeros.
+ */
+class PerfCounters {
+public:
+    static const int num_events = 6;
+
+private:
+    int fds[num_events];
+    uint64_t ids[num_events];
+    uint64_t counts[num_events];
+
+    // Whether some interval since the last print() went unmeasured.
+    bool unscheduled;
+
+#ifdef __linux__
+    static int open_event(uint32_t type, uint64_t config, int group) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = group == -1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                           PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+    }
+
+    static uint64_t cache_event(uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+#endif
+
+public:
+    static const char* name(int i) {
+        static const char* names[num_events] = {
+            "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses"
+        };
+        return names[i];
+    }
+
+    PerfCounters() {
+        for (int i = 0; i < num_events; i++) {
+            fds[i] = -1;
+            ids[i] = 0;
+            counts[i] = 0;
+        }
+        unscheduled = false;
+
+#ifdef __linux__
+        const uint32_t types[num_events] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE
+        };
+        const uint64_t configs[num_events] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, cache_event(PERF_COUNT_HW_CACHE_L1D),
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES, cache_event(PERF_COUNT_HW_CACHE_DTLB)
+        };
+
+        fds[0] = open_event(types[0], configs[0], -1);
+        if (fds[0] < 0)
+            return;
+
+        for (int i = 0; i < num_events; i++) {
+            if (i > 0)
+                fds[i] = open_event(types[i], configs[i], fds[0]);
+            if (fds[i] >= 0)
+                ioctl(fds[i], PERF_EVENT_IOC_ID, &ids[i]);
+        }
+#endif
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int i = 0; i < num_events; i++)
+            if (fds[i] >= 0)
+                close(fds[i]);
+#endif
+    }
+
+    bool available() const {
+        return fds[0] >= 0;
+    }
+
+    void start() {
+#ifdef __linux__
+        if (!available())
+            return;
+
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    void stop() {
+#ifdef __linux__
+        if (!available())
+            return;
+
+        ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        // { nr, time_enabled, time_running, { value, id } * nr }
+        uint64_t buf[3 + 2*num_events];
+        if (read(fds[0], buf, sizeof(buf)) <= 0)
+            return;
+
+        uint64_t enabled = buf[1], running = buf[2];
+        if (running == 0) {
+            unscheduled = true;
+            return;
+        }
+
+        double scale = running < enabled ? (double) enabled / running : 1.0;
+        for (uint64_t j = 0; j < buf[0]; j++)
+            for (int i = 0; i < num_events; i++)
+                if (fds[i] >= 0 && ids[i] == buf[4 + 2*j])
+                    counts[i] += (uint64_t) (buf[3 + 2*j] * scale);
+#endif
+    }
+
+    /**
+     * print - prints the counts as prefix_event=count and clears them
+     *
+     * Prints nothing if the counters aren't available, and
+     * prefix_counters=unscheduled if the PMU never ran the group during
+     * one of the intervals, since the counts would be short.
+     */
+    void print(const char* prefix) {
+        if (!available())
+            return;
+
+        if (unscheduled)
+            printf("%s_counters=unscheduled ", prefix);
+        for (int i = 0; i < num_events; i++) {
+            if (fds[i] >= 0 && !unscheduled)
+                printf("%s_%s=%llu ", prefix, name(i), (unsigned long long) counts[i]);
+            counts[i] = 0;
+        }
+        unscheduled = false;
+    }
+};
+
+#endif  // _PERF_COUNTERS_H_
@@ -0,0 +1,68 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <memory_resource>
+
+#include "common.h"
+#include "../src/hollow_heap.hpp"
+
+typedef HollowHeap<int, int> Heap;
+typedef HollowHeap<int, int, std::less<int>, unsigned, hh_default_policy,
+                   std::pmr::polymorphic_allocator<char>> PmrHeap;
+
+/**
+ * Runs many small queries, each with a heap of its own, once with the
+ * default allocator and once with every heap allocating from a stack
+ * buffer through a monotonic pmr resource. The resource's upstream is the
+ * null resource, so the second run would throw if it ever needed the
+ * global allocator; heaps of more than about a thousand elements outgrow
+ * the buffer.
+ */
+int main(int argc, char* argv[]) {
+    int seed = 0;
+    int queries = 100000;
+    int k = 256;
+
+    if (argc > 1)
+        sscanf(argv[1], "%d", &queries);
+    if (argc > 2)
+        sscanf(argv[2], "%d", &k);
+
+    srand(seed);
+    std::vector<int> keys(k);
+    for (int i = 0; i < k; i++)
+        keys[i] = rand() % (1 << 20);
+
+    printf("queries=%d k=%d ", queries, k);
+
+    long long int check_malloc = 0;
+    std::vector<Heap::reference> refs(k);
+    long long int pre_malloc = now();
+    for (int q = 0; q < queries; q++) {
+        Heap h;
+        check_malloc += query(h, keys, refs);
+    }
+    long long int post_malloc = now();
+
+    long long int check_pmr = 0;
+    std::vector<PmrHeap::reference> pmr_refs(k);
+    alignas(std::max_align_t) char buffer[1 << 18];
+    long long int pre_pmr = now();
+    for (int q = 0; q < queries; q++) {
+        std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+        PmrHeap h(&resource);
+        check_pmr += query(h, keys, pmr_refs);
+    }
+    long long int post_pmr = now();
+
+    printf("hhb_malloc=%lld hhb_pmr=%lld ", post_malloc - pre_malloc, post_pmr - pre_pmr);
+
+    if (check_malloc != check_pmr)
+        fprintf(stderr, "incorrect: the two runs differ\n");
+    else
+        fprintf(stderr, "correct!\n");
+
+    printf("\n");
+
+    return 0;
+}
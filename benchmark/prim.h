@@ -23,12 +23,13 @@ long long Benchmark<Heap>::prim(Graph* g) {
 
     log("computing the shortest path tree\n");
     long long int pre_compute = elapsed();
+    start_counters();
 
     Heap h;
-    node_map[0] = h.push(0, 0);
+    node_map[0] = push(h, 0, 0);
     weight_in[0] = 0;
     for (int i = 1; i < g->N; i++)
-        node_map[i] = h.push(INT_MAX, i);
+        node_map[i] = push(h, INT_MAX, i);
 
     while (!h.empty()) {
         int u = *h.find_min();
@@ -38,7 +39,7 @@ long long Benchmark<Heap>::prim(Graph* g) {
         in_mst[u] = 1;
         total_weight += weight_in[u];
 
-        h.delete_min();
+        delete_min(h);
 
         for (int i = 0; i < g->vertices[u].out_edges.size(); i++) {
             std::pair<int, int> vw = g->vertices[u].out_edges[i];
@@ -47,11 +48,12 @@ long long Benchmark<Heap>::prim(Graph* g) {
 
             if (in_mst[v] == 0 && w < d[v]) {
                 d[v] = w;
-                node_map[v] = h.decrease_key(node_map[v], d[v]);
+                node_map[v] = decrease_key(h, node_map[v], d[v]);
                 weight_in[v] = w;
             }
         }
     }
+    stop_counters();
     long long int post_compute = elapsed();
     log("elapsed = %lld us\n", post_compute - pre_compute);
 
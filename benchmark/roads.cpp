@@ -17,6 +17,8 @@ int main(int argc, char* argv[]) {
     argument* args = init_args(0, seed);
 
     Benchmark<HollowHeap<int, int>>("hhb").run(benchmarks, args);
+    Benchmark<HollowHeap<int, int, std::less<int>, unsigned, hh_prefetch_policy>>("hhpb").run(benchmarks, args);
+    Benchmark<HollowHeap<int, int, std::less<int>, unsigned, hh_multi_root_policy>>("hhmb").run(benchmarks, args);
     Benchmark<UnoptHollowHeap<int, int>>("uhhb").run(benchmarks, args);
     Benchmark<WrapperBoostFibonacciHeap<int, int>>("fhb").run(benchmarks, args);
     Benchmark<WrapperBoostRelaxedHeap<int, int>>("rhb").run(benchmarks, args);
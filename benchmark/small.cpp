@@ -0,0 +1,74 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "common.h"
+#include "../src/hollow_heap.hpp"
+
+typedef HollowHeap<int, int> Heap;
+typedef HollowHeap<int, int, std::less<int>, unsigned, hh_inline_policy<64>> InlineHeap;
+
+/**
+ * Runs many small queries three ways: with a fresh heap per query, with
+ * heaps taken from and given back to the thread's HollowHeapPool, and with
+ * a fresh heap that keeps up to 64 elements in inline arrays. The inline
+ * heap is on the stack, so it only allocates once a query outgrows them.
+ */
+int main(int argc, char* argv[]) {
+    int seed = 0;
+    int queries = 100000;
+    int k = 48;
+
+    if (argc > 1)
+        sscanf(argv[1], "%d", &queries);
+    if (argc > 2)
+        sscanf(argv[2], "%d", &k);
+
+    srand(seed);
+    std::vector<int> keys(k);
+    for (int i = 0; i < k; i++)
+        keys[i] = rand() % (1 << 20);
+
+    printf("queries=%d k=%d ", queries, k);
+
+    std::vector<Heap::reference> refs(k);
+
+    long long int check_fresh = 0;
+    long long int pre_fresh = now();
+    for (int q = 0; q < queries; q++) {
+        Heap h;
+        check_fresh += query(h, keys, refs);
+    }
+    long long int post_fresh = now();
+
+    long long int check_pool = 0;
+    HollowHeapPool<Heap>& pool = HollowHeapPool<Heap>::local();
+    long long int pre_pool = now();
+    for (int q = 0; q < queries; q++) {
+        Heap* h = pool.acquire();
+        check_pool += query(*h, keys, refs);
+        pool.release(h);
+    }
+    long long int post_pool = now();
+
+    long long int check_inline = 0;
+    std::vector<InlineHeap::reference> inline_refs(k);
+    long long int pre_inline = now();
+    for (int q = 0; q < queries; q++) {
+        InlineHeap h;
+        check_inline += query(h, keys, inline_refs);
+    }
+    long long int post_inline = now();
+
+    printf("hhb_fresh=%lld hhb_pool=%lld hhb_inline=%lld ",
+           post_fresh - pre_fresh, post_pool - pre_pool, post_inline - pre_inline);
+
+    if (check_fresh != check_pool || check_fresh != check_inline)
+        fprintf(stderr, "incorrect: the runs differ\n");
+    else
+        fprintf(stderr, "correct!\n");
+
+    printf("\n");
+
+    return 0;
+}
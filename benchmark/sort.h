@@ -16,16 +16,18 @@ long long int Benchmark<Heap>::sort(int N, int* nums) {
 
     log("inserting and retrieving numbers\n");
     long long int pre_insert = elapsed();
+    start_counters();
 
     Heap h;
     for (int i = 0; i < N; i++)
-        h.push(numbers[i], numbers[i]);
+        push(h, numbers[i], numbers[i]);
 
     while (!h.empty()) {
         results.push_back(*h.find_min());
-        h.delete_min();
+        delete_min(h);
     }
 
+    stop_counters();
     long long int post_retrieval = elapsed();
     log("elapsed: %lld us\n", post_retrieval - pre_insert);
 
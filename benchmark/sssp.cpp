@@ -0,0 +1,157 @@
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <utility>
+
+#include "common.h"
+#include "graphs.h"
+#include "argument.h"
+#include "../src/hollow_heap.hpp"
+#include "../src/hollow_multi_queue.hpp"
+
+typedef HollowHeap<int, int> Heap;
+typedef HollowMultiQueue<int, int> MultiQueue;
+
+/**
+ * relax - lowers @dist to @d if that's an improvement
+ *
+ * Returns true if it did.
+ */
+bool relax(std::atomic<int>& dist, int d) {
+    int old = dist.load(std::memory_order_relaxed);
+    while (d < old)
+        if (dist.compare_exchange_weak(old, d, std::memory_order_relaxed))
+            return true;
+    return false;
+}
+
+/**
+ * parallel_dijkstra - computes shortest path distances from vertex 0 on
+ *                     @threads threads sharing a HollowMultiQueue
+ *
+ * @g:       the graph
+ * @dist:    receives the distances
+ * @threads: the number of threads
+ * @pops:    receives the number of vertices popped, stale ones included
+ *
+ * The relaxed Dijkstra of the MultiQueue paper. A popped vertex isn't
+ * necessarily the closest one left, so it may be settled more than once.
+ * Improved vertices are pushed again rather than decreased; the copy with
+ * the old distance is skipped when it's popped. @pending counts vertices
+ * that are queued or being relaxed, so the threads stop once it's zero
+ * and the queue is empty.
+ *
+ * Returns the time spent in microseconds.
+ */
+long long int parallel_dijkstra(Graph* g, std::vector<int>& dist, int threads, long long int& pops) {
+    std::vector<std::atomic<int>> best(g->N);
+    for (int i = 0; i < g->N; i++)
+        best[i].store(1e9, std::memory_order_relaxed);
+    best[0].store(0, std::memory_order_relaxed);
+
+    MultiQueue q(threads);
+    std::atomic<long long int> pending(1);
+    std::atomic<long long int> popped(0);
+    q.push(0, 0);
+
+    long long int pre_compute = now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+        workers.emplace_back([&]() {
+            long long int local_pops = 0;
+            int d, u;
+
+            while (pending.load(std::memory_order_acquire) > 0) {
+                if (!q.try_pop(d, u)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                local_pops++;
+
+                if (d <= best[u].load(std::memory_order_relaxed)) {
+                    for (int i = 0; i < g->vertices[u].out_edges.size(); i++) {
+                        std::pair<int, int> vw = g->vertices[u].out_edges[i];
+                        int v = vw.first;
+                        int w = vw.second;
+
+                        if (relax(best[v], d+w)) {
+                            pending.fetch_add(1, std::memory_order_relaxed);
+                            q.push(d+w, v);
+                        }
+                    }
+                }
+
+                pending.fetch_sub(1, std::memory_order_release);
+            }
+
+            popped += local_pops;
+        });
+    for (int t = 0; t < threads; t++)
+        workers[t].join();
+    long long int post_compute = now();
+
+    dist.resize(g->N);
+    for (int i = 0; i < g->N; i++)
+        dist[i] = best[i].load(std::memory_order_relaxed);
+    pops = popped;
+
+    return post_compute - pre_compute;
+}
+
+void run(const char* name, Graph* g, int max_threads) {
+    std::vector<int> seq_dist, par_dist;
+
+    long long int seq = dijkstra<Heap>(g, seq_dist);
+    printf("hhb_%s_seq=%lld ", name, seq);
+
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        long long int pops;
+        long long int par = parallel_dijkstra(g, par_dist, threads, pops);
+
+        printf("hhb_mq_%s_t%d=%lld hhb_mq_%s_t%d_speedup=%.2f hhb_mq_%s_t%d_pops=%.2f ",
+               name, threads, par, name, threads, double(seq) / par,
+               name, threads, double(pops) / g->N);
+
+        if (seq_dist != par_dist)
+            fprintf(stderr, "incorrect: %s distances differ with %d threads\n", name, threads);
+        else
+            fprintf(stderr, "correct!\n");
+    }
+}
+
+/**
+ * Runs sequential Dijkstra on a HollowHeap and relaxed parallel Dijkstra
+ * on a HollowMultiQueue with 1, 2, 4, ... threads, on the random sparse
+ * and dense graphs for n (as all_tests does), or on the road graphs if n
+ * is 0. pops is the number of vertices popped per vertex in the graph.
+ */
+int main(int argc, char* argv[]) {
+    int seed = 0;
+    int n = 1 << 16;
+    int max_threads = std::max(4u, std::thread::hardware_concurrency());
+
+    if (argc > 1)
+        sscanf(argv[1], "%d", &n);
+    if (argc > 2)
+        sscanf(argv[2], "%d", &max_threads);
+
+    printf("n=%d ", n);
+
+    argument* args = init_args(n, seed);
+
+    if (n == 0) {
+        run("nyc", args->nyc_graph, max_threads);
+        run("bay", args->bay_graph, max_threads);
+    }
+    else {
+        run("sparse", args->sparse_graph, max_threads);
+        run("dense", args->dense_graph, max_threads);
+    }
+
+    printf("\n");
+
+    return 0;
+}
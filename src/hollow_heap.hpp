@@ -5,227 +5,1796 @@
 #include <vector>
 #include <cstring>
 #include <queue>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <memory>
+#include <new>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cassert>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define DEBUG 0
+
+#if defined(DEBUG) && DEBUG > 0
+#define DEBUG_PRINT(fmt, args...) \
+    fprintf(stderr, "DEBUG: %d:%s(): " fmt, __LINE__, __func__, ##args)
+#else
+#define DEBUG_PRINT(fmt, args...)
+#endif
+
+#define hh_node HollowHeapNode<K,Index>
+
+/**
+ * The hot part of a node: everything link() and delete_min touch. Items are
+ * kept in a separate array of slots so that walking the DAG never pulls item
+ * bytes into the cache. A slot is allocated once per element and @item
+ * follows it from node to node; hollow nodes have no item.
+ *
+ * Ranks are bounded by about 2 log n, so a byte is always enough.
+ */
+template<typename K, typename Index>
+struct HollowHeapNode {
+    K key;
+
+    Index id;
+    Index item;
+    Index children;
+    Index next;
+    Index second_parent;
+
+    uint8_t rank;
+    bool hollow;
+};
+
+/**
+ * Holds the comparator. Stateless comparators like std::less<K> are kept as
+ * an empty base so that they take up no space in the heap.
+ */
+template<typename Compare,
+         bool Empty = std::is_empty<Compare>::value && !std::is_final<Compare>::value>
+class HollowHeapCompare : private Compare {
+protected:
+    HollowHeapCompare(const Compare& compare) : Compare(compare) {}
+
+    const Compare& comp() const {
+        return *this;
+    }
+};
+
+template<typename Compare>
+class HollowHeapCompare<Compare, false> {
+    Compare compare;
+
+protected:
+    HollowHeapCompare(const Compare& _compare) : compare(_compare) {}
+
+    const Compare& comp() const {
+        return compare;
+    }
+};
+
+/**
+ * Arithmetic keys under std::less or std::greater can be compared without
+ * side effects, so link() evaluates both orders and picks the parent with
+ * conditional moves instead of branching.
+ */
+template<typename K, typename Compare>
+struct hh_branchless_compare : std::integral_constant<bool,
+    std::is_arithmetic<K>::value &&
+    (std::is_same<Compare, std::less<K>>::value ||
+     std::is_same<Compare, std::greater<K>>::value)> {};
+
+/**
+ * Compile-time switches for HollowHeap. To change one, derive from
+ * hh_default_policy and redefine just that member.
+ *
+ * @prefetch: have delete_min prefetch the next sibling and every node it
+ *            queues for deletion, so that walking a heap larger than the
+ *            cache overlaps its misses with linking work
+ * @stats:    count operations and high-water marks for HollowHeap::stats();
+ *            when off, none of that bookkeeping is compiled in
+ * @inline_capacity: nodes and items to keep inside the heap object before
+ *            the arena has to allocate, for heaps that are usually tiny
+ * @multi_root: keep a list of roots instead of a single one. push and
+ *            decrease_key add their new node to the list without linking
+ *            and all linking is left to delete_min, as in the multi-root
+ *            variant of the paper
+ */
+struct hh_default_policy {
+    static const bool prefetch = false;
+    static const bool stats = false;
+    static const size_t inline_capacity = 0;
+    static const bool multi_root = false;
+};
+
+struct hh_prefetch_policy : hh_default_policy {
+    static const bool prefetch = true;
+};
+
+struct hh_stats_policy : hh_default_policy {
+    static const bool stats = true;
+};
+
+struct hh_multi_root_policy : hh_default_policy {
+    static const bool multi_root = true;
+};
+
+template<size_t N>
+struct hh_inline_policy : hh_default_policy {
+    static_assert(N >= 2, "an inline arena needs room for at least two nodes");
+    static const size_t inline_capacity = N;
+};
+
+/**
+ * A snapshot of a heap's counters, as returned by HollowHeap::stats().
+ *
+ * The operation counts and high-water marks are only kept if the heap's
+ * policy has `stats` set and are zero otherwise; the sizes are always
+ * filled in. @arena_bytes covers the whole arena, which may be shared.
+ */
+struct HollowHeapStats {
+    uint64_t links;
+    uint64_t eqlinks;
+    uint64_t ranked;
+    uint64_t inserts;
+    uint64_t decs;
+    uint64_t rebuilds;
+
+    size_t nodes_full;
+    size_t nodes_hollow;
+    size_t arena_bytes;
+
+    unsigned max_rank;
+    size_t to_delete_peak;
+};
+
+/**
+ * An output iterator that drops whatever is written to it, for bulk
+ * operations whose caller has no use for the handles.
+ */
+struct hh_discard_iterator {
+    template<typename T>
+    hh_discard_iterator& operator=(const T&) {
+        return *this;
+    }
+
+    hh_discard_iterator& operator*() {
+        return *this;
+    }
+
+    hh_discard_iterator& operator++() {
+        return *this;
+    }
+
+    hh_discard_iterator operator++(int) {
+        return *this;
+    }
+};
+
+/**
+ * Backing memory for the arena's arrays. An allocator hands out raw bytes
+ * through allocate(bytes), reallocate(p, old_bytes, new_bytes) and
+ * deallocate(p, bytes); reallocate keeps the contents like realloc does.
+ *
+ * Standard allocators, those with a value_type such as std::allocator<T>
+ * or std::pmr::polymorphic_allocator<T>, work too. They are rebound to
+ * every array's type and grown by allocating, copying and deallocating.
+ */
+template<typename A, typename = void>
+struct hh_is_std_allocator : std::false_type {};
+
+template<typename A>
+struct hh_is_std_allocator<A, std::void_t<typename A::value_type>> : std::true_type {};
+
+struct hh_malloc_allocator {
+    void* allocate(size_t bytes) {
+        return malloc(bytes);
+    }
+
+    void* reallocate(void* p, size_t, size_t new_bytes) {
+        return realloc(p, new_bytes);
+    }
+
+    void deallocate(void* p, size_t) {
+        free(p);
+    }
+};
+
+#ifdef __linux__
+/**
+ * Maps every large array separately and grows it with mremap, which moves
+ * page table entries instead of copying, so doubling a large arena costs
+ * no copy and no reallocation spike. Mappings are MAP_NORESERVE and marked
+ * MADV_HUGEPAGE for transparent huge pages. Arrays below mmap_threshold,
+ * such as a small heap's arrays or the to_delete and compact buffers, come
+ * from malloc instead of taking a mapping and a system call each.
+ *
+ * @HugeTLB asks for MAP_HUGETLB pages, in 2 MiB multiples, for arrays of
+ * at least one huge page. If the huge page pool can't cover a mapping the
+ * allocator quietly falls back to normal pages for it.
+ *
+ * Which of the three an array lives in follows from its size alone, so an
+ * array that grows or shrinks across a threshold is copied over once.
+ */
+template<bool HugeTLB = false>
+struct hh_mmap_allocator {
+    static const size_t huge_page = 2 << 20;
+    static const size_t mmap_threshold = 128 << 10;
+
+    enum kind { heap, pages, huge_pages };
+
+    static kind kind_of(size_t bytes) {
+        if (bytes < mmap_threshold)
+            return heap;
+        if (HugeTLB && bytes >= huge_page)
+            return huge_pages;
+        return pages;
+    }
+
+    static size_t round_up(size_t bytes, size_t to) {
+        return (bytes + to - 1) / to * to;
+    }
+
+    static size_t mapping_size(size_t bytes) {
+        if (kind_of(bytes) == huge_pages)
+            return round_up(bytes, huge_page);
+        return round_up(bytes, sysconf(_SC_PAGESIZE));
+    }
+
+    void* allocate(size_t bytes) {
+        kind k = kind_of(bytes);
+        if (k == heap)
+            return malloc(bytes);
+
+        size_t size = mapping_size(bytes);
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+        void* p = MAP_FAILED;
+
+        // Without a reservation a hugetlb mapping succeeds even if the pool
+        // is empty and faults with SIGBUS later, so this one must reserve.
+        if (k == huge_pages)
+            p = mmap(NULL, size, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+        if (p == MAP_FAILED) {
+            p = mmap(NULL, size, PROT_READ | PROT_WRITE, flags | MAP_NORESERVE, -1, 0);
+            if (p == MAP_FAILED)
+                return NULL;
+            madvise(p, size, MADV_HUGEPAGE);
+        }
+
+        return p;
+    }
+
+    // Moves an array to where its new size belongs.
+    void* copy_over(void* p, size_t old_bytes, size_t new_bytes) {
+        void* q = allocate(new_bytes);
+        if (q) {
+            memcpy(q, p, old_bytes < new_bytes ? old_bytes : new_bytes);
+            deallocate(p, old_bytes);
+        }
+        return q;
+    }
+
+    void* reallocate(void* p, size_t old_bytes, size_t new_bytes) {
+        kind k = kind_of(old_bytes);
+        if (k != kind_of(new_bytes))
+            return copy_over(p, old_bytes, new_bytes);
+        if (k == heap)
+            return realloc(p, new_bytes);
+
+        size_t old_size = mapping_size(old_bytes), new_size = mapping_size(new_bytes);
+        if (old_size == new_size)
+            return p;
+
+        void* q = mremap(p, old_size, new_size, MREMAP_MAYMOVE);
+        if (q != MAP_FAILED) {
+            if (new_size > old_size)
+                madvise((char*) q + old_size, new_size - old_size, MADV_HUGEPAGE);
+            return q;
+        }
+
+        // Some kernels can't mremap hugetlb mappings.
+        return copy_over(p, old_bytes, new_bytes);
+    }
+
+    void deallocate(void* p, size_t bytes) {
+        if (kind_of(bytes) == heap)
+            free(p);
+        else
+            munmap(p, mapping_size(bytes));
+    }
+};
+#endif
+
+/**
+ * Whether a T can be moved to another address by copying its bytes and
+ * forgetting the original. The arena grows arrays of such keys and items
+ * with realloc; anything else is moved element by element.
+ *
+ * Trivially copyable types qualify. Specialize this for other types known
+ * to be safe, e.g. std::unique_ptr, to get realloc growth back for them.
+ */
+template<typename T>
+struct hh_is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+/**
+ * Room for the first @N nodes and item slots inside the arena object. The
+ * arena starts out on these arrays and only allocates once it outgrows
+ * them.
+ */
+template<typename K, typename I, typename Index, size_t N>
+struct HollowHeapInlineStorage {
+    alignas(hh_node) unsigned char node_bytes[N * sizeof(hh_node)];
+    alignas(I) unsigned char item_bytes[N * sizeof(I)];
+    Index item_node[N];
+
+    hh_node* nodes() {
+        return (hh_node*) node_bytes;
+    }
+
+    I* items() {
+        return (I*) item_bytes;
+    }
+
+    Index* item_nodes() {
+        return item_node;
+    }
+
+    bool contains(const void* p) const {
+        return (const char*) p >= (const char*) this && (const char*) p < (const char*) (this + 1);
+    }
+};
+
+template<typename K, typename I, typename Index>
+struct HollowHeapInlineStorage<K, I, Index, 0> {
+    hh_node* nodes() {
+        return NULL;
+    }
+
+    I* items() {
+        return NULL;
+    }
+
+    Index* item_nodes() {
+        return NULL;
+    }
+
+    bool contains(const void*) const {
+        return false;
+    }
+};
+
+/**
+ * HollowHeapArena - node and item slot storage for hollow heaps
+ *
+ * A heap normally owns a private arena. Heaps constructed on a shared arena
+ * number their nodes and handles in the same space, which is what lets
+ * HollowHeap::meld run in O(1). The arena must outlive the heaps using it.
+ */
+template<typename K, typename I, typename Index = unsigned, typename Allocator = hh_malloc_allocator,
+         size_t InlineCapacity = 0>
+class HollowHeapArena {
+public:
+    typedef K key_type;
+    typedef I item_type;
+
+    Allocator alloc;
+    HollowHeapInlineStorage<K, I, Index, InlineCapacity> inline_storage;
+
+    // Everything the arena and the heaps on it allocate goes through these,
+    // and so through @alloc.
+    template<typename T>
+    static T* allocate_array(Allocator& alloc, size_t n) {
+        if constexpr (hh_is_std_allocator<Allocator>::value) {
+            typedef typename std::allocator_traits<Allocator>::template rebind_alloc<T> array_allocator;
+            array_allocator a(alloc);
+            return std::allocator_traits<array_allocator>::allocate(a, n);
+        }
+        else
+            return (T*) alloc.allocate(n * sizeof(T));
+    }
+
+    template<typename T>
+    static void free_array(Allocator& alloc, T* p, size_t n) {
+        if constexpr (hh_is_std_allocator<Allocator>::value) {
+            typedef typename std::allocator_traits<Allocator>::template rebind_alloc<T> array_allocator;
+            array_allocator a(alloc);
+            std::allocator_traits<array_allocator>::deallocate(a, p, n);
+        }
+        else
+            alloc.deallocate(p, n * sizeof(T));
+    }
+
+    template<typename T>
+    T* allocate_array(size_t n) {
+        return allocate_array<T>(alloc, n);
+    }
+
+    template<typename T>
+    void free_array(T* p, size_t n) {
+        if (!inline_storage.contains(p))
+            free_array(alloc, p, n);
+    }
+
+    template<typename T>
+    T* resize_array(T* p, size_t old_n, size_t new_n) {
+        if constexpr (!hh_is_std_allocator<Allocator>::value) {
+            if (!inline_storage.contains(p))
+                return (T*) alloc.reallocate(p, old_n * sizeof(T), new_n * sizeof(T));
+        }
+
+        // Standard allocators can't resize, and the inline arrays can't move.
+        T* q = allocate_array<T>(new_n);
+        memcpy((void*) q, (void*) p, (old_n < new_n ? old_n : new_n) * sizeof(T));
+        free_array(p, old_n);
+        return q;
+    }
+
+    size_t nodes_used;
+    size_t nodes_alloc_size;
+    hh_node* nodes;
+
+    // Dead nodes are chained through their `next` field and handed back out
+    // by make_new_node before the array is grown. A free node has id 0.
+    Index free_list;
+    size_t nodes_free;
+
+    // Item slots double as element handles. `item_node` maps a slot to the
+    // node currently holding its item; free slots are chained through it.
+    size_t items_used;
+    size_t items_alloc_size;
+    item_type* items;
+    Index* item_node;
+    Index item_free_list;
+
+    HollowHeapArena(const Allocator& _alloc = Allocator()) : alloc(_alloc) {
+        free_list = 0;
+        nodes_free = 0;
+        nodes_used = 0;
+
+        item_free_list = 0;
+        items_used = 0;
+
+        if (InlineCapacity) {
+            nodes_alloc_size = InlineCapacity;
+            nodes = inline_storage.nodes();
+
+            items_alloc_size = InlineCapacity;
+            items = inline_storage.items();
+            item_node = inline_storage.item_nodes();
+        }
+        else {
+            nodes_alloc_size = 1024;
+            nodes = allocate_array<hh_node>(nodes_alloc_size);
+
+            items_alloc_size = 1024;
+            items = allocate_array<item_type>(items_alloc_size);
+            item_node = allocate_array<Index>(items_alloc_size);
+        }
+    }
+
+    // The arena owns its arrays, which may be inline, so copying or moving
+    // it would free them twice.
+    HollowHeapArena(const HollowHeapArena&) = delete;
+    HollowHeapArena& operator=(const HollowHeapArena&) = delete;
+
+    ~HollowHeapArena() {
+        destroy_all();
+        free_array(nodes, nodes_alloc_size);
+        free_array(items, items_alloc_size);
+        free_array(item_node, items_alloc_size);
+    }
+
+    // Keys are constructed when a node is made and destroyed when it is
+    // freed; hollow nodes keep theirs, since links still compare them. An
+    // item lives from make_new_item to free_item, and a slot is in use
+    // exactly when a full node holds it.
+    static const bool trivial_keys = std::is_trivially_destructible<K>::value;
+    static const bool trivial_items = std::is_trivially_destructible<I>::value;
+
+    // Moves a node to a slot with no key constructed in it.
+    static void relocate_node(hh_node* to, hh_node* from) {
+        memcpy((void*) to, (void*) from, sizeof(hh_node));
+        if constexpr (!hh_is_trivially_relocatable<K>::value) {
+            new (&to->key) K(std::move(from->key));
+            from->key.~K();
+        }
+    }
+
+    void resize_nodes(size_t alloc_size) {
+        if constexpr (hh_is_trivially_relocatable<K>::value)
+            nodes = resize_array(nodes, nodes_alloc_size, alloc_size);
+        else {
+            hh_node* q = allocate_array<hh_node>(alloc_size);
+            size_t n = nodes_used+1 < alloc_size ? nodes_used+1 : alloc_size;
+
+            // Free nodes only need their links.
+            memcpy((void*) q, (void*) nodes, n * sizeof(hh_node));
+            for (size_t i = 1; i < n; i++)
+                if (nodes[i].id)
+                    relocate_node(q+i, nodes+i);
+
+            free_array(nodes, nodes_alloc_size);
+            nodes = q;
+        }
+        nodes_alloc_size = alloc_size;
+    }
+
+    // @pending is a slot that was just filled but isn't held by a node yet.
+    void resize_items(size_t alloc_size, Index pending = 0) {
+        if constexpr (hh_is_trivially_relocatable<I>::value)
+            items = resize_array(items, items_alloc_size, alloc_size);
+        else {
+            item_type* q = allocate_array<item_type>(alloc_size);
+
+            auto relocate = [&](Index slot) {
+                new (q+slot) I(std::move(items[slot]));
+                items[slot].~I();
+            };
+            for (size_t i = 1; i <= nodes_used; i++)
+                if (nodes[i].id && !nodes[i].hollow)
+                    relocate(nodes[i].item);
+            if (pending)
+                relocate(pending);
+
+            free_array(items, items_alloc_size);
+            items = q;
+        }
+        item_node = resize_array(item_node, items_alloc_size, alloc_size);
+        items_alloc_size = alloc_size;
+    }
+
+    // Destroys every key and item still alive.
+    void destroy_all() {
+        if (trivial_keys && trivial_items)
+            return;
+
+        for (size_t i = 1; i <= nodes_used; i++) {
+            if (!nodes[i].id)
+                continue;
+            if (!nodes[i].hollow)
+                items[nodes[i].item].~I();
+            nodes[i].key.~K();
+        }
+    }
+
+    // Index 0 means "none", so Index can number this many nodes or items.
+    static constexpr size_t max_index = std::numeric_limits<Index>::max() - 1;
+
+    template<typename KeyArg>
+    inline hh_node* make_new_node(KeyArg&& key, Index item) {
+        Index index;
+        if (free_list) {
+            index = free_list;
+            free_list = nodes[index].next;
+            nodes_free--;
+        }
+        else {
+            if (nodes_used >= max_index)
+                throw std::length_error("HollowHeapArena: out of node indices");
+            index = ++nodes_used;
+        }
+
+        hh_node* result = nodes+index;
+        result->id = index;
+        result->next = result->children = result->second_parent = 0;
+        result->rank = 0;
+        result->hollow = 0;
+        new (&result->key) K(std::forward<KeyArg>(key));
+        result->item = item;
+
+        // Grow only after the key is constructed, as @key may point into
+        // the array.
+        if (nodes_used+1 >= nodes_alloc_size)
+            resize_nodes(2 * nodes_alloc_size);
+
+        return nodes+index;
+    }
+
+    /**
+     * clear - forgets all nodes and item slots but keeps the memory
+     */
+    void clear() {
+        destroy_all();
+
+        free_list = 0;
+        nodes_free = 0;
+        nodes_used = 0;
+
+        item_free_list = 0;
+        items_used = 0;
+    }
+
+    inline void free_node(Index u) {
+        if (!trivial_keys)
+            nodes[u].key.~K();
+        nodes[u].id = 0;
+        nodes[u].next = free_list;
+        free_list = u;
+        nodes_free++;
+    }
+
+    template<typename... Args>
+    inline Index make_new_item(Args&&... args) {
+        Index index;
+        if (item_free_list) {
+            index = item_free_list;
+            item_free_list = item_node[index];
+        }
+        else {
+            if (items_used >= max_index)
+                throw std::length_error("HollowHeapArena: out of item indices");
+            index = ++items_used;
+        }
+
+        new (items+index) I(std::forward<Args>(args)...);
+
+        if (items_used+1 >= items_alloc_size)
+            resize_items(2 * items_alloc_size, index);
+
+        return index;
+    }
+
+    inline void free_item(Index index) {
+        if (!trivial_items)
+            items[index].~I();
+        item_node[index] = item_free_list;
+        item_free_list = index;
+    }
+
+    /**
+     * reserve_nodes - makes room for @n more nodes without growing
+     */
+    void reserve_nodes(size_t n) {
+        if (nodes_used+n+1 >= nodes_alloc_size) {
+            size_t alloc_size = nodes_alloc_size;
+            while (nodes_used+n+1 >= alloc_size)
+                alloc_size *= 2;
+            resize_nodes(alloc_size);
+        }
+    }
+
+    /**
+     * reserve - makes room for @n more nodes and items without growing
+     */
+    void reserve(size_t n) {
+        reserve_nodes(n);
+
+        if (items_used+n+1 >= items_alloc_size) {
+            size_t alloc_size = items_alloc_size;
+            while (items_used+n+1 >= alloc_size)
+                alloc_size *= 2;
+            resize_items(alloc_size);
+        }
+    }
+
+    /**
+     * compact - moves all live nodes to the front of the node array
+     *
+     * @root: the root of the only heap using this arena
+     *
+     * Renumbers the live nodes densely and shrinks the allocation. Item
+     * slots, and so handles, are not affected. Returns the new number of
+     * @root.
+     */
+    Index compact(Index root) {
+        if (nodes_free == 0)
+            return root;
+
+        Index* remap = allocate_array<Index>(nodes_used+1);
+        Index live = 0;
+        remap[0] = 0;
+        for (size_t i = 1; i <= nodes_used; i++)
+            remap[i] = nodes[i].id ? ++live : 0;
+
+        // remap[i] <= i, so a forward sweep never overwrites a node that
+        // hasn't been moved yet.
+        for (size_t i = 1; i <= nodes_used; i++) {
+            if (!remap[i])
+                continue;
+
+            hh_node* node = nodes+remap[i];
+            if (remap[i] != i)
+                relocate_node(node, nodes+i);
+
+            node->id = remap[i];
+            node->children = remap[node->children];
+            node->next = remap[node->next];
+            node->second_parent = remap[node->second_parent];
+            if (!node->hollow)
+                item_node[node->item] = remap[i];
+        }
+
+        root = remap[root];
+        free_array(remap, nodes_used+1);
+
+        free_list = 0;
+        nodes_free = 0;
+        nodes_used = live;
+
+        size_t alloc_size = 1024;
+        while (nodes_used+1 >= alloc_size)
+            alloc_size *= 2;
+        if (alloc_size < nodes_alloc_size)
+            resize_nodes(alloc_size);
+
+        return root;
+    }
+};
+
+/**
+ * HollowHeap - a hollow heap ordered by @Compare
+ *
+ * Compare(a, b) returns true if a key a comes out of the heap before b. The
+ * default, std::less<K>, gives a min-heap and std::greater<K> a max-heap.
+ * find_min, delete_min and decrease_key refer to this order, so for a
+ * max-heap decrease_key is the operation that raises a key.
+ *
+ * Nodes and item slots are numbered with @Index, which limits the heap to
+ * std::numeric_limits<Index>::max() - 1 nodes, hollow ones included. An
+ * operation that would need more throws std::length_error. uint16_t packs
+ * nodes tightly for small heaps; uint64_t lifts the limit for huge ones.
+ *
+ * @Policy turns optional code paths on at compile time; see
+ * hh_default_policy. @Allocator backs the arena's arrays, see
+ * hh_malloc_allocator and hh_mmap_allocator.
+ */
+template<typename K, typename I, typename Compare = std::less<K>, typename Index = unsigned,
+         typename Policy = hh_default_policy, typename Allocator = hh_malloc_allocator>
+class HollowHeap : private HollowHeapCompare<Compare> {
+public:
+    typedef HollowHeapArena<K, I, Index, Allocator, Policy::inline_capacity> arena_type;
+    typedef Index reference;
+    typedef K key_type;
+    typedef I item_type;
+
+private:
+    using HollowHeapCompare<Compare>::comp;
+
+    Index root;
+
+    // With Policy::multi_root, every root is on a list chained through
+    // `next`, which roots don't otherwise use, and `root` is the one with
+    // the minimum key.
+    Index root_list;
+    Index root_tail;
+
+    // One root per rank during delete_min's linking pass. A full node of
+    // rank r has at least about phi^r descendants, so two ranks per bit of
+    // Index cover any heap the arena can address. rankmask has a bit set
+    // for every occupied slot so the final pass only visits those.
+    static const unsigned max_rank = 16 * sizeof(Index);
+    static const unsigned rankmask_words = (max_rank + 63) / 64;
+
+    Index rankmap[max_rank];
+    uint64_t rankmask[rankmask_words];
+
+    inline void set_rank(unsigned rank, Index u) {
+        if constexpr (Policy::stats) {
+            if (rank > max_rank_seen)
+                max_rank_seen = rank;
+        }
+
+        rankmap[rank] = u;
+        rankmask[rank / 64] |= (uint64_t) 1 << (rank % 64);
+    }
+
+    inline void clear_rank(unsigned rank) {
+        rankmap[rank] = 0;
+        rankmask[rank / 64] &= ~((uint64_t) 1 << (rank % 64));
+    }
+
+    // to_delete starts out on the inline array and moves to the arena's
+    // allocator once it outgrows it.
+    static const size_t inline_to_delete_size = 32;
+
+    Index* to_delete;
+    size_t to_delete_index;
+    size_t to_delete_used;
+    size_t to_delete_alloc_size;
+    Index inline_to_delete[inline_to_delete_size];
+
+    inline void expand_to_delete() {
+        if constexpr (Policy::stats) {
+            if (to_delete_used > to_delete_peak)
+                to_delete_peak = to_delete_used;
+        }
+
+        if (to_delete_used >= to_delete_alloc_size) {
+            if (to_delete == inline_to_delete) {
+                to_delete = arena->template allocate_array<Index>(2 * to_delete_alloc_size);
+                std::copy(inline_to_delete, inline_to_delete + to_delete_alloc_size, to_delete);
+            }
+            else
+                to_delete = arena->resize_array(to_delete, to_delete_alloc_size, 2 * to_delete_alloc_size);
+            to_delete_alloc_size *= 2;
+        }
+    }
+
+    // Child visits an operation may spend on hollow nodes that can't hold
+    // the minimum, 0 for no limit; see set_delete_budget().
+    size_t delete_budget;
+
+    // The incremental rebuild: full nodes whose child lists are still to be
+    // swept, and the list being swept, which resumes at the child after
+    // `sweep_pred`, or at the head if that is 0.
+    Index* sweep_stack;
+    size_t sweep_used;
+    size_t sweep_alloc_size;
+    Index sweep_parent;
+    Index sweep_pred;
+    bool sweeping;
+
+    // A private arena lives in `own_arena`, so a heap that fits in its
+    // inline arrays doesn't allocate at all.
+    arena_type* arena;
+    bool owns_arena;
+    alignas(arena_type) unsigned char own_arena[sizeof(arena_type)];
+
+    // Number of full (non-hollow) nodes, i.e. elements in the heap, and of
+    // all nodes this heap holds in the arena.
+    size_t nodes_full;
+    size_t nodes_in_use;
+
+    // Only kept up to date if Policy::stats is set; see count().
+    uint64_t ranked, eqlinks, links, inserts, decs, rebuilds;
+    unsigned max_rank_seen;
+    size_t to_delete_peak;
+
+    inline void count(uint64_t& counter, uint64_t n = 1) {
+        if constexpr (Policy::stats)
+            counter += n;
+    }
+
+    Index link(Index u, Index v) {
+        hh_node* nodes = arena->nodes;
+        DEBUG_PRINT("call to link %d(%d) and %d(%d)\n", u, nodes[u].key, v, nodes[v].key);
+
+        count(links);
+        Index parent = u, child = v;
+        if constexpr (hh_branchless_compare<K, Compare>::value) {
+            bool before = comp()(nodes[u].key, nodes[v].key);
+            bool after = comp()(nodes[v].key, nodes[u].key);
+            bool u_wins = before | (!after & (nodes[u].rank < nodes[v].rank));
+
+            Index mask = (Index) -(Index) u_wins;
+
+            count(eqlinks, !before & !after);
+            parent = v ^ ((u ^ v) & mask);
+            child = u ^ v ^ parent;
+        }
+        else {
+            if (comp()(nodes[u].key, nodes[v].key))
+                parent = u, child = v;
+            else if (comp()(nodes[v].key, nodes[u].key))
+                parent = v, child = u;
+            else {
+                count(eqlinks);
+                if (nodes[u].rank < nodes[v].rank)
+                    parent = u, child = v;
+                else
+                    parent = v, child = u;
+            }
+        }
+
+        DEBUG_PRINT("winner: %d(%d)\n", parent, nodes[parent].key);
+        nodes[child].next = nodes[parent].children;
+        nodes[parent].children = child;
+        return parent;
+    }
+
+    // Adds a new node to the heap: a link with the root, or with
+    // Policy::multi_root a place on the root list and one comparison.
+    inline void add_root(Index v) {
+        hh_node* nodes = arena->nodes;
+
+        if (!root) {
+            root = v;
+            if constexpr (Policy::multi_root) {
+                nodes[v].next = 0;
+                root_list = root_tail = v;
+            }
+            return;
+        }
+
+        if constexpr (Policy::multi_root) {
+            nodes[v].next = root_list;
+            root_list = v;
+            if (comp()(nodes[v].key, nodes[root].key))
+                root = v;
+        }
+        else
+            root = link(root, v);
+    }
+
+    // After linking everything into `root`, makes it the only one listed.
+    inline void reset_root_list() {
+        if constexpr (Policy::multi_root) {
+            root_list = root_tail = root;
+            if (root)
+                arena->nodes[root].next = 0;
+        }
+    }
+
+    /**
+     * collect_nodes - puts every node of the heap into `to_delete`
+     *
+     * Each node is listed once. A hollow node with two parents is only
+     * descended into from its second parent, whose child list it ends.
+     * Nodes are listed parents first and their fields are left untouched.
+     */
+    void collect_nodes() {
+        hh_node* nodes = arena->nodes;
+
+        to_delete_used = 0;
+        if (!root)
+            return;
+
+        if constexpr (Policy::multi_root) {
+            // A listed hollow node that still has a second parent is
+            // reached from there.
+            for (Index r = root_list; r; r = nodes[r].next) {
+                if (nodes[r].hollow && nodes[r].second_parent)
+                    continue;
+
+                to_delete[to_delete_used++] = r;
+                expand_to_delete();
+            }
+        }
+        else {
+            to_delete[to_delete_used++] = root;
+            expand_to_delete();
+        }
+
+        for (size_t i = 0; i < to_delete_used; i++) {
+            Index parent = to_delete[i];
+            Index cur = nodes[parent].children;
+            while (cur) {
+                Index next = nodes[cur].next;
+
+                if (nodes[cur].second_parent != parent && nodes[cur].second_parent) {
+                    cur = next;
+                    continue;
+                }
+
+                to_delete[to_delete_used++] = cur;
+                expand_to_delete();
+
+                if (nodes[cur].second_parent == parent)
+                    break;
+
+                cur = next;
+            }
+        }
+    }
+
+    // Makes an item slot and a full node holding it, and returns the slot.
+    // If the arena runs out of node indices the slot is given back.
+    template<typename KeyArg, typename... Args>
+    Index make_element(KeyArg&& key, Args&&... args) {
+        Index slot = arena->make_new_item(std::forward<Args>(args)...);
+        try {
+            arena->item_node[slot] = arena->make_new_node(std::forward<KeyArg>(key), slot)->id;
+        }
+        catch (...) {
+            arena->free_item(slot);
+            throw;
+        }
+        return slot;
+    }
+
+    // Accounts for the @n elements a push_range made and hangs the winner
+    // of their links, @batch_root, off the heap.
+    void end_push_range(Index batch_root, size_t n) {
+        count(inserts, n);
+        nodes_full += n;
+        nodes_in_use += n;
+
+        if (batch_root)
+            add_root(batch_root);
+    }
+
+    void init(arena_type* _arena, bool _owns_arena) {
+        root = 0;
+        root_list = root_tail = 0;
+
+        memset(rankmap, 0, sizeof(rankmap));
+        memset(rankmask, 0, sizeof(rankmask));
+
+        arena = _arena;
+        owns_arena = _owns_arena;
+
+        to_delete_alloc_size = inline_to_delete_size;
+        to_delete = inline_to_delete;
+
+        delete_budget = 0;
+        sweep_stack = NULL;
+        sweep_used = sweep_alloc_size = 0;
+        sweep_parent = sweep_pred = 0;
+        sweeping = false;
+
+        eqlinks = links = ranked = 0;
+        inserts = decs = rebuilds = 0;
+        max_rank_seen = 0;
+        to_delete_peak = 0;
+
+        nodes_full = 0;
+        nodes_in_use = 0;
+    }
+
+    // Gives our nodes and item slots back to a shared arena.
+    void release_nodes() {
+        collect_nodes();
+        for (size_t i = 0; i < to_delete_used; i++) {
+            if (!arena->nodes[to_delete[i]].hollow)
+                arena->free_item(arena->nodes[to_delete[i]].item);
+            arena->free_node(to_delete[i]);
+        }
+    }
+
+    inline void sweep_push(Index u) {
+        if (sweep_used == sweep_alloc_size) {
+            size_t alloc_size = sweep_alloc_size ? 2 * sweep_alloc_size : 64;
+            if (sweep_stack)
+                sweep_stack = arena->resize_array(sweep_stack, sweep_alloc_size, alloc_size);
+            else
+                sweep_stack = arena->template allocate_array<Index>(alloc_size);
+            sweep_alloc_size = alloc_size;
+        }
+        sweep_stack[sweep_used++] = u;
+    }
+
+    inline void stop_sweep() {
+        sweeping = false;
+        sweep_used = 0;
+        sweep_parent = sweep_pred = 0;
+    }
+
+    void start_sweep() {
+        stop_sweep();
+        sweeping = true;
+
+        if constexpr (Policy::multi_root) {
+            for (Index r = root_list; r; r = arena->nodes[r].next)
+                if (!arena->nodes[r].hollow)
+                    sweep_push(r);
+        }
+        else if (root)
+            sweep_push(root);
+    }
+
+    // Points whatever comes after @pred in @p's child list, or the list
+    // itself if @pred is 0, at @u.
+    inline void set_after(Index p, Index pred, Index u) {
+        if (pred)
+            arena->nodes[pred].next = u;
+        else
+            arena->nodes[p].children = u;
+    }
+
+    /**
+     * sweep - takes up to @work steps of the incremental rebuild
+     *
+     * Walks the child lists of the full nodes from the roots down. A hollow
+     * child with no other parent is replaced by its own children one at a
+     * time, which keeps heap order since it was no smaller than any of
+     * them, and is freed once it has none left. A hollow child with two
+     * parents is dropped from this list and stays in the other one. Each
+     * step is O(1).
+     *
+     * Operations in between may free or relink nodes. A stacked node that
+     * turns out to be free or hollow is skipped, and remove_root drops the
+     * list being swept if it frees or truncates it; whatever the sweep
+     * misses that way is left to the next one. Only a heap on its own
+     * arena sweeps, so a freed node that is handed out again is still one
+     * of ours.
+     */
+    void sweep(size_t work) {
+        hh_node* nodes = arena->nodes;
+
+        for (; work; work--) {
+            if (!sweep_parent) {
+                if (!sweep_used) {
+                    sweeping = false;
+                    return;
+                }
+
+                Index p = sweep_stack[--sweep_used];
+                if (nodes[p].id == p && !nodes[p].hollow) {
+                    sweep_parent = p;
+                    sweep_pred = 0;
+                }
+                continue;
+            }
+
+            Index p = sweep_parent;
+            Index c = sweep_pred ? nodes[sweep_pred].next : nodes[p].children;
+            if (!c) {
+                sweep_parent = 0;
+                continue;
+            }
+
+            hh_node* cur = nodes+c;
+            if (!cur->hollow) {
+                sweep_push(c);
+                sweep_pred = c;
+            }
+            else if (cur->second_parent == p) {
+                // The list ends at its second child, which stays with its
+                // first parent.
+                set_after(p, sweep_pred, 0);
+                cur->second_parent = 0;
+                sweep_parent = 0;
+            }
+            else if (cur->second_parent) {
+                // Stays with its second parent, where it's the last child.
+                set_after(p, sweep_pred, cur->next);
+                cur->next = 0;
+                cur->second_parent = 0;
+            }
+            else if (!cur->children) {
+                set_after(p, sweep_pred, cur->next);
+                arena->free_node(c);
+                nodes_in_use--;
+            }
+            else {
+                Index u = cur->children;
+                if (nodes[u].hollow && nodes[u].second_parent == c) {
+                    nodes[u].second_parent = 0;
+                    cur->children = 0;
+                }
+                else {
+                    // Move the first child in front of us; it's looked at
+                    // next.
+                    cur->children = nodes[u].next;
+                    nodes[u].next = c;
+                    set_after(p, sweep_pred, u);
+                }
+            }
+        }
+    }
+
+    // Hollow nodes below long-lived full nodes are never reached by
+    // delete_min. Don't let them outnumber the elements for too long.
+    inline void limit_hollow() {
+        if (delete_budget && owns_arena) {
+            if (!sweeping && nodes_in_use - nodes_full > nodes_full + 1024)
+                start_sweep();
+            if (sweeping)
+                sweep(delete_budget);
+        }
+
+        if (nodes_in_use - nodes_full > 2 * nodes_full + 1024)
+            rebuild();
+    }
+
+public:
+    /**
+     * HollowHeap - constructor
+     *
+     * @compare: the comparator instance to order keys with
+     * @alloc:   the allocator for the heap's arena and buffers
+     */
+    HollowHeap(const Compare& compare = Compare(), const Allocator& alloc = Allocator())
+        : HollowHeapCompare<Compare>(compare) {
+        init(new (own_arena) arena_type(alloc), true);
+    }
+
+    HollowHeap(const Allocator& alloc) : HollowHeap(Compare(), alloc) {
+    }
+
+    /**
+     * HollowHeap - constructor that fills the heap from a range
+     *
+     * @first, @last: a range of (key, item) pairs
+     * @compare:      the comparator instance to order keys with
+     * @alloc:        the allocator for the heap's arena and buffers
+     */
+    template<typename InputIt>
+    HollowHeap(InputIt first, InputIt last, const Compare& compare = Compare(),
+               const Allocator& alloc = Allocator()) : HollowHeap(compare, alloc) {
+        push_range(first, last);
+    }
+
+    /**
+     * HollowHeap - constructor for a heap on a shared arena
+     *
+     * @arena:   the arena to keep nodes and items in, whose allocator the
+     *           heap uses for its own buffers too
+     * @compare: the comparator instance to order keys with
+     */
+    HollowHeap(arena_type& _arena, const Compare& compare = Compare()) : HollowHeapCompare<Compare>(compare) {
+        init(&_arena, false);
+    }
+
+    // The heap points into itself, at `own_arena` and `inline_to_delete`,
+    // so it can be neither copied nor moved. Use meld to combine heaps.
+    HollowHeap(const HollowHeap&) = delete;
+    HollowHeap& operator=(const HollowHeap&) = delete;
+
+    ~HollowHeap() {
+        if (!owns_arena)
+            release_nodes();
+
+        if (to_delete != inline_to_delete)
+            arena->free_array(to_delete, to_delete_alloc_size);
+        if (sweep_stack)
+            arena->free_array(sweep_stack, sweep_alloc_size);
+        if (owns_arena)
+            arena->~arena_type();
+    }
+
+    /**
+     * clear - removes every element, keeping the memory for reuse
+     *
+     * Unlike a fresh heap, a cleared one doesn't have to grow its arrays
+     * again, so a heap that is cleared between short-lived uses stops
+     * allocating after the first few.
+     */
+    void clear() {
+        if (owns_arena)
+            arena->clear();
+        else
+            release_nodes();
+
+        root = 0;
+        root_list = root_tail = 0;
+        nodes_full = 0;
+        nodes_in_use = 0;
+        stop_sweep();
+    }
+
+    /**
+     * reserve - makes room for @n more elements
+     *
+     * Grows the arena once up front, so that the next @n pushes don't
+     * reallocate on the way.
+     */
+    void reserve(size_t n) {
+        arena->reserve(n);
+    }
+
+    /*
+     * find_min - returns the minimum element in the heap
+     *
+     * Returns a pointer to the item corresponding to the minimum key if the
+     * number of elements in the heap is at least 1.
+     */
+    inline item_type* find_min() {
+        if (!root)
+            return NULL;
+        
+        return arena->items+arena->nodes[root].item;
+    }
+
+    /**
+     * find_min_key - returns a pointer to the minimum key, or NULL if the
+     *                heap is empty
+     */
+    inline const key_type* find_min_key() {
+        if (!root)
+            return NULL;
+
+        return &arena->nodes[root].key;
+    }
+
+    /**
+     * contains - tells whether a handle still refers to an element
+     *
+     * @h: a handle returned by push at some point
+     *
+     * False once the element has been deleted. Its slot may then be reused
+     * by a later push, after which @h refers to the new element.
+     */
+    bool contains(reference h) {
+        if (!h || h > arena->items_used)
+            return false;
+
+        // A deleted element's slot is chained to other free slots, but no
+        // full node holds it.
+        Index u = arena->item_node[h];
+        if (!u || u > arena->nodes_used)
+            return false;
+
+        hh_node* node = arena->nodes+u;
+        return node->id == u && !node->hollow && node->item == h;
+    }
+
+    /**
+     * key - returns the key of an element
+     *
+     * @h: the element's reference handle
+     */
+    inline const key_type& key(reference h) {
+        return arena->nodes[arena->item_node[h]].key;
+    }
+
+    /**
+     * item - returns the item of an element
+     *
+     * @h: the element's reference handle
+     */
+    inline item_type& item(reference h) {
+        return arena->items[h];
+    }
+
+    /**
+     * push - pushes a (key, item) pair into the heap
+     *
+     * @key:  a key object that is comparable
+     * @item: the item itself
+     *
+     * Both are copied in, or moved if both are rvalues; emplace moves
+     * either one on its own. Returns a reference handle for the element.
+     * The handle stays valid until the element is deleted, no matter how
+     * often its key changes.
+     */
+    reference push(const key_type& key, const item_type& item) {
+        return emplace(key, item);
+    }
+
+    reference push(key_type&& key, item_type&& item) {
+        return emplace(std::move(key), std::move(item));
+    }
+
+    /**
+     * emplace - pushes an element whose item is constructed in place
+     *
+     * @key:  a key object that is comparable, moved in if it's an rvalue
+     * @args: the arguments to construct the item from
+     *
+     * Returns a reference handle for the element, like push.
+     */
+    template<typename KeyArg, typename... Args>
+    reference emplace(KeyArg&& key, Args&&... args) {
+        DEBUG_PRINT("push %d\n", key);
 
-#define DEBUG 0
+        // Create a new node and link it to the existing DAG.
+        Index slot = make_element(std::forward<KeyArg>(key), std::forward<Args>(args)...);
+        count(inserts);
+        nodes_full++;
+        nodes_in_use++;
+        add_root(arena->item_node[slot]);
 
-#if defined(DEBUG) && DEBUG > 0
-#define DEBUG_PRINT(fmt, args...) \
-    fprintf(stderr, "DEBUG: %d:%s(): " fmt, __LINE__, __func__, ##args)
-#else
-#define DEBUG_PRINT(fmt, args...)
-#endif
+        return slot;
+    }
 
-#define hh_node HollowHeapNode<K,I>
+    /**
+     * push_range - pushes a range of (key, item) pairs into the heap
+     *
+     * @first, @last: a range of pairs with the key in `first` and the item
+     *                in `second`
+     * @handles:     an output iterator that receives one reference handle
+     *                per element, in order
+     *
+     * Room for the whole range is reserved up front if its length is known.
+     * The new nodes are linked among themselves and the winner is linked
+     * to the root once at the end; with Policy::multi_root they are just
+     * listed. Returns @handles past the last handle.
+     *
+     * If the arena runs out of indices partway, the elements pushed so far
+     * stay in the heap, with their handles written out, before the
+     * std::length_error is passed on.
+     */
+    template<typename InputIt, typename OutputIt>
+    OutputIt push_range(InputIt first, InputIt last, OutputIt handles) {
+        typedef typename std::iterator_traits<InputIt>::iterator_category category;
+        if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value)
+            arena->reserve(std::distance(first, last));
+
+        Index batch_root = 0;
+        size_t n = 0;
+        try {
+            for (; first != last; ++first, n++) {
+                Index slot = make_element(first->first, first->second);
+                Index v = arena->item_node[slot];
+                *handles++ = slot;
+
+                if constexpr (Policy::multi_root)
+                    add_root(v);
+                else if (!batch_root)
+                    batch_root = v;
+                else
+                    batch_root = link(batch_root, v);
+            }
+        }
+        catch (...) {
+            end_push_range(batch_root, n);
+            throw;
+        }
 
-template<typename K, typename I>
-struct HollowHeapNode {
-    K key;
-    I item;
+        end_push_range(batch_root, n);
+        return handles;
+    }
 
-    unsigned id;
-    unsigned children;
-    unsigned next;
-    unsigned second_parent;
+    template<typename InputIt>
+    void push_range(InputIt first, InputIt last) {
+        push_range(first, last, hh_discard_iterator());
+    }
 
-    unsigned rank;
-    bool hollow;
-};
+    /**
+     * decrease_key - decreases the key of an element
+     *
+     * @h:       the element's reference handle
+     * @new_key: the new key value
+     *
+     * Returns @h, which remains valid. Callers don't need to store it back;
+     * it's returned so that code written for heaps whose handles move keeps
+     * working.
+     */
+    reference decrease_key(reference h, const key_type& new_key) {
+        Index u = arena->item_node[h];
+        DEBUG_PRINT("decreasing %d: %d->%d\n", u, arena->nodes[u].key, new_key);
+        count(decs);
 
-template<typename K, typename I>
-class HollowHeap {
-private:
-    typedef K key_type;
-    typedef I item_type;
+        // If this the given node is already the root node, decreasing the key
+        // will not change the heap. Just set the new key and move on.
+        if (arena->nodes[u].id == root) {
+            DEBUG_PRINT("given node is the root\n");
+            arena->nodes[u].key = new_key;
+            return h;
+        }
 
-    unsigned root;
+        // Otherwise create a new node and hand it the item slot.
+        Index v = arena->make_new_node(new_key, h)->id;
+        nodes_in_use++;
 
-    unsigned* rankmap;
-    int rankmap_alloc_size;
+        hh_node* nodes = arena->nodes;
+        nodes[u].item = 0;
+        arena->item_node[h] = v;
 
-    inline void expand_rankmap(unsigned rank) {
-        if (rank >= rankmap_alloc_size) {
-            rankmap_alloc_size *= 2;
-            rankmap = (unsigned*) realloc(rankmap, rankmap_alloc_size * sizeof(unsigned));
-            memset(rankmap+rank, 0, rank * sizeof(unsigned));
-        }
-    }
+        if (nodes[u].rank > 2)
+            nodes[v].rank = nodes[u].rank - 2;
+        else
+            nodes[v].rank = 0;
 
-    unsigned* to_delete;
-    int to_delete_index;
-    int to_delete_used;
-    int to_delete_alloc_size;
+        nodes[u].hollow = 1;
 
-    inline void expand_to_delete() {
-        if (to_delete_used >= to_delete_alloc_size) {
-            to_delete_alloc_size *= 2;
-            to_delete = (unsigned*) realloc(to_delete, to_delete_alloc_size * sizeof(unsigned));
+        // A listed new node has no children yet, so it can take the old one
+        // right away.
+        if constexpr (Policy::multi_root) {
+            nodes[v].children = u;
+            nodes[u].second_parent = v;
+            add_root(v);
+            limit_hollow();
+            return h;
         }
-    }
 
-    int nodes_used;
-    int nodes_alloc_size;
-    hh_node* nodes;
+        // If the original root is the winner, the old node gains a second
+        // parent in the form of the new node.
+        Index old_root = root;
+        root = link(root, v);
+        if (root == old_root) {
+            nodes[v].children = nodes[u].id;
+            nodes[u].second_parent = v;
+        }
 
-    int ranked, eqlinks, links, inserts, decs;
+        limit_hollow();
+        return h;
+    }
 
-    unsigned link(unsigned u, unsigned v) {
-        DEBUG_PRINT("call to link %d(%d) and %d(%d)\n", u, nodes[u].key, v, nodes[v].key);
+    /**
+     * decrease_key_range - decreases the keys of a batch of elements
+     *
+     * @first, @last: a range of pairs with a reference handle in `first`
+     *                and its new key in `second`; no handle may appear
+     *                twice in one batch
+     * @results:     an output iterator that receives the handle of every
+     *                element, in order
+     *
+     * Same as calling decrease_key on every pair, but the new nodes are
+     * linked among themselves first and only their winner is linked to the
+     * root, so the batch doesn't serialize on the root. Each old node is
+     * made a child of its replacement up front. Returns @results past the
+     * last handle.
+     *
+     * If the arena runs out of node indices partway, the keys decreased so
+     * far keep their new values before the std::length_error is passed on;
+     * the rest are left alone.
+     */
+    template<typename InputIt, typename OutputIt>
+    OutputIt decrease_key_range(InputIt first, InputIt last, OutputIt results) {
+        // Decreases make nodes but never item slots.
+        typedef typename std::iterator_traits<InputIt>::iterator_category category;
+        if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value)
+            arena->reserve_nodes(std::distance(first, last));
+
+        Index batch_root = 0;
+        try {
+            for (; first != last; ++first) {
+                reference h = first->first;
+                Index u = arena->item_node[h];
+                count(decs);
+
+                if (u == root) {
+                    arena->nodes[u].key = first->second;
+                    *results++ = h;
+                    continue;
+                }
 
-        links++;
-        unsigned parent = u, child = v;
-        if (nodes[u].key < nodes[v].key)
-            parent = u, child = v;
-        else if (nodes[v].key < nodes[u].key)
-            parent = v, child = u;
-        else {
-            eqlinks++;
-            if (nodes[u].rank < nodes[v].rank)
-                parent = u, child = v;
-            else
-                parent = v, child = u;
+                Index v = arena->make_new_node(first->second, h)->id;
+                nodes_in_use++;
+
+                hh_node* nodes = arena->nodes;
+                nodes[u].item = 0;
+                arena->item_node[h] = v;
+
+                if (nodes[u].rank > 2)
+                    nodes[v].rank = nodes[u].rank - 2;
+                else
+                    nodes[v].rank = 0;
+
+                nodes[u].hollow = 1;
+                nodes[v].children = u;
+                nodes[u].second_parent = v;
+                *results++ = h;
+
+                if constexpr (Policy::multi_root)
+                    add_root(v);
+                else if (!batch_root)
+                    batch_root = v;
+                else
+                    batch_root = link(batch_root, v);
+            }
+        }
+        catch (...) {
+            // Every node in the batch already holds its item.
+            if (batch_root)
+                add_root(batch_root);
+            throw;
         }
 
-        DEBUG_PRINT("winner: %d(%d)\n", parent, nodes[parent].key);
-        nodes[child].next = nodes[parent].children;
-        nodes[parent].children = child;
-        return parent;
+        if (batch_root)
+            add_root(batch_root);
+
+        limit_hollow();
+        return results;
     }
 
-public:
-    typedef unsigned reference;
+    template<typename InputIt>
+    void decrease_key_range(InputIt first, InputIt last) {
+        decrease_key_range(first, last, hh_discard_iterator());
+    }
 
     /**
-     * HollowHeap - constructor
+     * meld - moves all elements of another heap into this one
+     *
+     * @other: a heap on the same arena as this one; it is left empty
+     *
+     * This is a single link, or a splice of the two root lists with
+     * Policy::multi_root, so it takes O(1) time. Handles from @other stay
+     * valid and refer to elements of this heap afterwards. Melding a heap
+     * with itself does nothing.
      */
-    HollowHeap() {
-        root = 0;
-
-        rankmap_alloc_size = 16;
-        rankmap = (unsigned*) calloc(rankmap_alloc_size, sizeof(unsigned));
+    void meld(HollowHeap& other) {
+        if (&other == this)
+            return;
 
-        to_delete_alloc_size = 32;
-        to_delete = (unsigned*) malloc(to_delete_alloc_size * sizeof(unsigned));
+        // Nodes are numbered per arena, so there is nothing to splice
+        // between two of them.
+        assert(arena == other.arena && "meld needs heaps on a shared arena");
 
-        eqlinks = links = ranked = 0;
-        inserts = decs = 0;
+        if constexpr (Policy::multi_root) {
+            if (other.root) {
+                if (!root) {
+                    root = other.root;
+                    root_list = other.root_list;
+                }
+                else {
+                    arena->nodes[root_tail].next = other.root_list;
+                    if (comp()(arena->nodes[other.root].key, arena->nodes[root].key))
+                        root = other.root;
+                }
+                root_tail = other.root_tail;
+            }
+            other.root_list = other.root_tail = 0;
+        }
+        else if (other.root) {
+            if (!root)
+                root = other.root;
+            else
+                root = link(root, other.root);
+        }
 
-        nodes_used = 0;
-        nodes_alloc_size = 1024;
-        nodes = (hh_node*) malloc(nodes_alloc_size * sizeof(hh_node));
-    }
+        nodes_full += other.nodes_full;
+        nodes_in_use += other.nodes_in_use;
 
-    ~HollowHeap() {
-        free(rankmap);
-        free(to_delete);
-        free(nodes);
+        other.root = 0;
+        other.nodes_full = 0;
+        other.nodes_in_use = 0;
     }
 
-    inline hh_node* make_new_node(const key_type& key, const item_type& item) {
-        nodes_used++;
+    /**
+     * rebuild - discards all hollow nodes and relinks the full ones
+     *
+     * Full nodes stay where they are. This is the rebuilding step from the
+     * paper that keeps the number of nodes linear in the number of elements;
+     * it costs O(nodes in use).
+     */
+    void rebuild() {
+        count(rebuilds);
+        stop_sweep();
+        collect_nodes();
+
+        // collect_nodes lists parents first, so by the time a node is
+        // relinked its old child list has been fully read.
+        hh_node* nodes = arena->nodes;
+        root = 0;
+        for (size_t i = 0; i < to_delete_used; i++) {
+            Index u = to_delete[i];
+            if (nodes[u].hollow)
+                continue;
 
-        hh_node* result = nodes+nodes_used;
-        result->id = nodes_used;
-        result->next = result->children = result->second_parent = 0;
-        result->rank = 0;
-        result->hollow = 0;
-        result->key = key;
-        result->item = item;
+            nodes[u].children = nodes[u].next = nodes[u].second_parent = 0;
+            nodes[u].rank = 0;
 
-        if (nodes_used+1 >= nodes_alloc_size) {
-            nodes_alloc_size *= 2;
-            nodes = (hh_node*) realloc(nodes, (nodes_alloc_size) * sizeof(hh_node));
+            if (!root)
+                root = u;
+            else
+                root = link(root, u);
         }
+        reset_root_list();
 
-        return nodes+nodes_used;
+        // Hollow nodes are freed last, as free_node reuses `next`.
+        for (size_t i = 0; i < to_delete_used; i++) {
+            if (nodes[to_delete[i]].hollow) {
+                arena->free_node(to_delete[i]);
+                nodes_in_use--;
+            }
+        }
     }
 
-    /*
-     * find_min - returns the minimum element in the heap
+    /**
+     * compact - drops hollow nodes and shrinks the node array
      *
-     * Returns a pointer to the item corresponding to the minimum key if the
-     * number of elements in the heap is at least 1.
+     * Recycled nodes keep the array from growing past the peak number of
+     * nodes in use, but the peak itself is never given back. Calling this
+     * once in a while rebuilds the heap and renumbers its nodes densely.
+     * Reference handles are not affected. Heaps on a shared arena can't be
+     * renumbered, so for them this only rebuilds.
      */
-    inline item_type* find_min() {
+    void compact() {
+        if (nodes_in_use > nodes_full || (Policy::multi_root && root_list != root_tail))
+            rebuild();
+        if (owns_arena) {
+            stop_sweep();
+            root = arena->compact(root);
+            reset_root_list();
+        }
+    }
+
+    /**
+     * delete_min - removes the element with the minimum key
+     */
+    void delete_min() {
         if (!root)
-            return NULL;
-        
-        return &((nodes+root)->item);
+            return;
+
+        nodes_full--;
+        arena->free_item(arena->nodes[root].item);
+        remove_root();
+
+        if (delete_budget)
+            limit_hollow();
     }
 
     /**
-     * push - pushes a (key, item) pair into the heap
+     * erase - removes an arbitrary element from the heap
      *
-     * @key:  a key object that is comparable
-     * @item: the item itself
+     * @h: the element's reference handle, which becomes invalid
      *
-     * Returns a pointer to a HollowHeapNode<K, I> that's supposed to serve
-     * as a reference handle. This will be required for future operations.
+     * The element's node is just marked hollow and is cleaned up once all
+     * of its parents are gone, so this takes O(1) unless @h is the root.
      */
-    reference push(const key_type& key, const item_type& item) {
-        DEBUG_PRINT("push %d\n", key);
-        inserts++;
+    void erase(reference h) {
+        Index u = arena->item_node[h];
+        DEBUG_PRINT("erasing %d\n", u);
 
-        // Create a new node and link it to the existing DAG.
-        hh_node* new_node = make_new_node(key, item);
-        DEBUG_PRINT("new node %p(%d)\n", new_node, key);
+        nodes_full--;
+        arena->free_item(h);
 
-        if (!root)
-            root = new_node->id;
-        else
-            root = link(root, nodes_used);
-        
-        return nodes_used;
+        if (u == root) {
+            remove_root();
+            return;
+        }
+
+        arena->nodes[u].item = 0;
+        arena->nodes[u].hollow = 1;
+        limit_hollow();
     }
 
     /**
-     * decrease_key - decreases the key on a particular node
+     * increase_key - increases the key of an element
      *
-     * @u:       a pointer to a HollowHeapNode<K, I>
+     * @h:       the element's reference handle
      * @new_key: the new key value
      *
-     * Returns a possibly new pointer to the same item (it may be stored in
-     * a different node after the decrease_key operation).
+     * The old node is erased and the item moves into a freshly inserted
+     * node, keeping its slot. Returns @h, which remains valid.
      */
-    reference decrease_key(reference u, const key_type& new_key) {
-        DEBUG_PRINT("decreasing %d: %d->%d\n", u, nodes[u].key, new_key);
-        decs++;
+    reference increase_key(reference h, const key_type& new_key) {
+        Index u = arena->item_node[h];
+        DEBUG_PRINT("increasing %d: %d->%d\n", u, arena->nodes[u].key, new_key);
 
-        // If this the given node is already the root node, decreasing the key
-        // will not change the heap. Just set the new key and move on.
-        if (nodes[u].id == root) {
-            DEBUG_PRINT("given node is the root\n");
-            nodes[u].key = new_key;
-            return u;
-        }
+        // The new node stays out of the DAG until the old one is gone.
+        Index v = arena->make_new_node(new_key, h)->id;
+        nodes_in_use++;
 
-        // Otherwise create a new node and move the item.
-        make_new_node(new_key, nodes[u].item);
+        arena->nodes[u].item = 0;
+        arena->nodes[u].hollow = 1;
+        if (u == root)
+            remove_root();
 
-        if (nodes[u].rank > 2)
-            nodes[nodes_used].rank = nodes[u].rank - 2;
-        else
-            nodes[nodes_used].rank = 0;
+        arena->item_node[h] = v;
+        add_root(v);
 
-        nodes[u].hollow = 1;
+        limit_hollow();
+        return h;
+    }
 
-        // If the original root is the winner, the old node gains a second
-        // parent in the form of the new node.
-        unsigned old_root = root;
-        root = link(root, nodes_used);
-        if (root == old_root) {
-            nodes[nodes_used].children = nodes[u].id;
-            nodes[u].second_parent = nodes_used;
-        }
+    /**
+     * set_delete_budget - bounds the work an operation spends on hollow
+     *                     nodes that can't hold the minimum
+     *
+     * @budget: child visits per operation, or 0 (the default) for no limit
+     *
+     * Once delete_min has visited @budget children, it stops expanding a
+     * hollow node if a full node it has released has no greater key: the
+     * hollow node's subtree can't hold the new minimum, so it is hung
+     * below that full node and expanded by whichever delete_min reaches it
+     * next. find_min stays exact. Full children are all candidates for the
+     * minimum, and so is what lies below a hollow node with a smaller key,
+     * so those are still visited; a delete_min is only as bounded as its
+     * candidates are.
+     *
+     * A heap on its own arena also stops rebuilding all at once. When
+     * hollow nodes outnumber full ones it starts an incremental sweep that
+     * decrease_key, erase, increase_key and delete_min advance by @budget
+     * steps each. The rebuild stays as a backstop at twice as many hollow
+     * nodes, which a budget of a few times the hollow nodes an operation
+     * makes keeps from ever firing.
+     */
+    void set_delete_budget(size_t budget) {
+        delete_budget = budget;
+    }
+
+    /**
+     * stats - returns a snapshot of the heap's counters and sizes
+     */
+    HollowHeapStats stats() const {
+        HollowHeapStats s;
 
-        // Return v so that the caller may update their node table.
-        return nodes_used;
+        s.links = links;
+        s.eqlinks = eqlinks;
+        s.ranked = ranked;
+        s.inserts = inserts;
+        s.decs = decs;
+        s.rebuilds = rebuilds;
+
+        s.nodes_full = nodes_full;
+        s.nodes_hollow = nodes_in_use - nodes_full;
+        s.arena_bytes = arena->nodes_alloc_size * sizeof(hh_node) +
+                        arena->items_alloc_size * (sizeof(I) + sizeof(Index));
+
+        s.max_rank = max_rank_seen;
+        s.to_delete_peak = to_delete_peak;
+
+        return s;
     }
 
     bool empty() {
         return !root;
     }
 
-    void print(unsigned index, int level=0) {
+    void print(Index index, int level=0) {
+        hh_node* nodes = arena->nodes;
         if (level == 0)
             printf("\n");
 
@@ -235,7 +1804,7 @@ public:
             printf("+--");
         printf("%d.%d.%d\n", index, nodes[index].key, nodes[index].rank);
 
-        unsigned next = nodes[index].children;
+        Index next = nodes[index].children;
         if (next == 0)
             return;
 
@@ -253,23 +1822,190 @@ public:
     }
 
     void print_root() {
-        print(root, 0);
+        if constexpr (Policy::multi_root) {
+            for (Index r = root_list; r; r = arena->nodes[r].next)
+                print(r, 0);
+        }
+        else
+            print(root, 0);
     }
 
-    void delete_min() {
-        if (!root)
-            return;
+private:
+    /**
+     * release_child - hands a child of a node being deleted to the next
+     *                 round of linking
+     *
+     * @cur:    the child, whose `next` the caller has already read
+     * @parent: the node being deleted, 0 for the root list
+     *
+     * Full children are linked by rank. Hollow ones are queued for deletion
+     * once this was their last parent. Returns true if @cur ends @parent's
+     * child list as a child of its second parent.
+     */
+    inline bool release_child(hh_node* cur, Index parent) {
+        hh_node* nodes = arena->nodes;
+
+        if (cur->hollow == 0) {
+            while (rankmap[cur->rank]) {
+                hh_node* other = nodes+rankmap[cur->rank];
+
+                clear_rank(cur->rank);
+
+                DEBUG_PRINT("cur=%p(%d) other=%p(%d)\n", cur, cur->key, other, other->key);
+                cur = nodes+link(cur->id, other->id);
+                count(ranked);
+
+                (cur->rank)++;
+            }
+
+            set_rank(cur->rank, cur->id);
+        }
+        else {
+            if (!cur->second_parent) {
+                if constexpr (Policy::prefetch) {
+                    if (cur->children)
+                        __builtin_prefetch(nodes+cur->children);
+                }
+
+                to_delete[to_delete_used++] = cur->id;
+                expand_to_delete();
+            }
+            else {
+                if (cur->second_parent == parent) {
+                    cur->second_parent = 0;
+                    return true;
+                }
+                else {
+                    cur->second_parent = 0;
+                    cur->next = 0;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    // The ranked root with the smallest key, 0 if there is none.
+    Index smallest_ranked() {
+        hh_node* nodes = arena->nodes;
+        Index best = 0;
+
+        for (unsigned w = 0; w < rankmask_words; w++) {
+            for (uint64_t mask = rankmask[w]; mask; mask &= mask - 1) {
+                Index u = rankmap[64*w + __builtin_ctzll(mask)];
+                if (!best || comp()(nodes[u].key, nodes[best].key))
+                    best = u;
+            }
+        }
+
+        return best;
+    }
+
+    /**
+     * release_budgeted - release_child, charged to the delete budget
+     *
+     * @work: the children visited so far
+     * @best: once @work reaches the budget, a released full node with a
+     *        key as small as we've seen; 0 until then
+     */
+    inline bool release_budgeted(hh_node* cur, Index parent, size_t& work, Index& best) {
+        if (!delete_budget)
+            return release_child(cur, parent);
+
+        Index u = cur->id;
+        bool full = !cur->hollow;
+        bool last = release_child(cur, parent);
+
+        if (++work == delete_budget)
+            best = smallest_ranked();
+        else if (work > delete_budget && full) {
+            hh_node* nodes = arena->nodes;
+            if (!best || comp()(nodes[u].key, nodes[best].key))
+                best = u;
+        }
+
+        return last;
+    }
+
+    // Whether a hollow node that lost all of its parents may wait below
+    // @best, i.e. whether its subtree can't hold the new minimum.
+    inline bool deferrable(Index u, Index best) {
+        return best && !comp()(arena->nodes[u].key, arena->nodes[best].key);
+    }
+
+    /**
+     * defer - hangs a deferrable hollow node below a released full node
+     *         instead of expanding it
+     *
+     * The ranked root with the largest key that isn't greater than @u's is
+     * picked, and @best if there is none, so that @u is only reached again
+     * once the heap gets down to about its key rather than by the next
+     * delete_min.
+     */
+    void defer(Index u, Index best) {
+        hh_node* nodes = arena->nodes;
+        Index parent = best;
+
+        for (unsigned w = 0; w < rankmask_words; w++) {
+            for (uint64_t mask = rankmask[w]; mask; mask &= mask - 1) {
+                Index r = rankmap[64*w + __builtin_ctzll(mask)];
+                if (!comp()(nodes[u].key, nodes[r].key) && comp()(nodes[parent].key, nodes[r].key))
+                    parent = r;
+            }
+        }
 
-        int max_rank = -1;
+        nodes[u].next = nodes[parent].children;
+        nodes[parent].children = u;
+    }
+
+    /**
+     * remove_root - deletes the root node and relinks what's left
+     *
+     * The root's item, if any, must have been released by the caller. The
+     * root then goes through `to_delete` like any other hollow node. With
+     * a delete budget, nodes in `to_delete` past the budget may be
+     * deferred rather than expanded; their entries are cleared to 0.
+     */
+    void remove_root() {
+        hh_node* nodes = arena->nodes;
+        size_t work = 0, deferred = 0;
+        Index best = 0;
 
         DEBUG_PRINT("pushing %d(%d) into `to_delete`\n", root, nodes[root].key);
+        nodes[root].item = 0;
+        nodes[root].hollow = 1;
         to_delete_index = 0;
         to_delete_used = 0;
         to_delete[to_delete_used++] = root;
         expand_to_delete();
 
+        // The other roots on the list are released like children of the
+        // root; this is where the multi-root variant does its linking.
+        if constexpr (Policy::multi_root) {
+            Index r = root_list;
+            while (r) {
+                Index next = nodes[r].next;
+                if (r != root)
+                    release_budgeted(nodes+r, 0, work, best);
+                r = next;
+            }
+        }
+
         while (to_delete_index < to_delete_used) {
             hh_node* parent = nodes+to_delete[to_delete_index];
+
+            if (deferrable(parent->id, best)) {
+                defer(parent->id, best);
+                to_delete[to_delete_index++] = 0;
+                deferred++;
+                continue;
+            }
+
+            if constexpr (Policy::prefetch) {
+                if (to_delete_index+1 < to_delete_used)
+                    __builtin_prefetch(nodes+to_delete[to_delete_index+1]);
+            }
+
             DEBUG_PRINT("outer loop: parent = %p(%d)\n", parent, parent->key);
 
             hh_node* cur = NULL;
@@ -280,69 +2016,128 @@ public:
             hh_node* next;
             while (cur != NULL) {
                 next = NULL;
-                if (cur->next)
+                if (cur->next) {
                     next = nodes+cur->next;
+                    if constexpr (Policy::prefetch)
+                        __builtin_prefetch(next);
+                }
 
                 DEBUG_PRINT("[cur=%p(%d)] next=%p(%d)\n", cur, cur->key, next, next == NULL ? -1 : next->key);
 
-                if (cur->hollow == 0) {
-                    while (cur->rank < rankmap_alloc_size && rankmap[cur->rank]) {
-                        hh_node* other = nodes+rankmap[cur->rank];
-
-                        rankmap[cur->rank] = 0;
-
-                        DEBUG_PRINT("cur=%p(%d) other=%p(%d)\n", cur, cur->key, other, other->key);
-                        cur = nodes+link(cur->id, other->id);
-                        ranked++;
-
-                        (cur->rank)++;
-                    }
-
-                    expand_rankmap(cur->rank);
-                    rankmap[cur->rank] = cur->id;
-
-                    if (max_rank < 0 || max_rank < cur->rank)
-                        max_rank = cur->rank;
-                }
-                else {
-                    if (!cur->second_parent) {
-                        to_delete[to_delete_used++] = cur->id;
-                        expand_to_delete();
-                    }
-                    else {
-                        if (cur->second_parent == parent->id) {
-                            cur->second_parent = 0;
-                            break;
-                        }
-                        else {
-                            cur->second_parent = 0;
-                            cur->next = 0;
-                        }
-                    }
+                // Ran out of budget partway: the node keeps the rest of
+                // its list.
+                if (deferrable(parent->id, best)) {
+                    parent->children = cur->id;
+                    defer(parent->id, best);
+                    if (parent->id == sweep_parent)
+                        sweep_parent = 0;
+                    to_delete[to_delete_index] = 0;
+                    deferred++;
+                    break;
                 }
 
+                if (release_budgeted(cur, parent->id, work, best))
+                    break;
+
                 cur = next;
             }
 
             to_delete_index++;
         }
 
-        if (max_rank < 0) {
-            root = 0;
-            return;
+        // Everything else that went through `to_delete` has lost all of its
+        // parents and can be recycled.
+        nodes_in_use -= to_delete_used - deferred;
+        if (!deferred) {
+            for (size_t i = 0; i < to_delete_used; i++)
+                arena->free_node(to_delete[i]);
+        }
+        else {
+            for (size_t i = 0; i < to_delete_used; i++)
+                if (to_delete[i])
+                    arena->free_node(to_delete[i]);
         }
 
-        root = rankmap[max_rank];
-        rankmap[max_rank] = 0;
-        for (int i = max_rank-1; i >= 0; i--) {
-            if (rankmap[i]) {
-                root = link(root, rankmap[i]);
-                rankmap[i] = 0;
+        // The list being swept is gone if its node was.
+        if (sweep_parent && !nodes[sweep_parent].id)
+            sweep_parent = 0;
+
+        // Link the remaining roots from the highest rank down.
+        root = 0;
+        for (int w = rankmask_words-1; w >= 0; w--) {
+            while (rankmask[w]) {
+                unsigned rank = 64*w + 63 - __builtin_clzll(rankmask[w]);
+                Index u = rankmap[rank];
+
+                clear_rank(rank);
+                root = root ? link(root, u) : u;
             }
         }
+        reset_root_list();
 
         DEBUG_PRINT("%d(%d) is now root\n", root, nodes[root].key);
     }
 };
 
+/**
+ * HollowHeapPool - a free list of cleared heaps
+ *
+ * For code that runs many short queries, each wanting an empty heap:
+ * acquire() hands out a heap that kept its arrays from an earlier query
+ * instead of allocating new ones, and release() clears it and takes it
+ * back. Up to @Capacity heaps are kept; more are deleted on release.
+ *
+ * A pool isn't thread-safe. local() returns one for the calling thread.
+ */
+template<typename Heap, size_t Capacity = 8>
+class HollowHeapPool {
+    Heap* heaps[Capacity];
+    size_t count;
+
+public:
+    HollowHeapPool() {
+        count = 0;
+    }
+
+    ~HollowHeapPool() {
+        for (size_t i = 0; i < count; i++)
+            delete heaps[i];
+    }
+
+    HollowHeapPool(const HollowHeapPool&) = delete;
+    HollowHeapPool& operator=(const HollowHeapPool&) = delete;
+
+    /**
+     * local - returns the calling thread's pool
+     */
+    static HollowHeapPool& local() {
+        static thread_local HollowHeapPool pool;
+        return pool;
+    }
+
+    /**
+     * acquire - returns an empty heap
+     */
+    Heap* acquire() {
+        if (count)
+            return heaps[--count];
+        return new Heap();
+    }
+
+    /**
+     * release - empties @heap and puts it back into the pool
+     *
+     * @heap: a heap from acquire()
+     */
+    void release(Heap* heap) {
+        if (count == Capacity) {
+            delete heap;
+            return;
+        }
+
+        heap->clear();
+        heaps[count++] = heap;
+    }
+};
+
 #endif // _HOLLOW_HEAP_H_
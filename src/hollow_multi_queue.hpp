@@ -0,0 +1,231 @@
+#ifndef _HOLLOW_MULTI_QUEUE_H_
+#define _HOLLOW_MULTI_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <type_traits>
+
+#include "hollow_heap.hpp"
+
+/**
+ * HollowMultiQueue - a concurrent relaxed priority queue of hollow heaps
+ *
+ * The MultiQueue of Rihani, Sanders and Dementiev: c·P sequential heaps,
+ * each behind its own try-lock. push goes to a random shard. try_pop looks
+ * at the minima of two random shards and pops from the better one, so it
+ * returns an element close to, but not always exactly, the global
+ * minimum. Threads that find a shard locked just pick another one.
+ *
+ * Each shard publishes the key of its minimum in an atomic so that picking
+ * a shard takes no lock; @K must therefore be trivially copyable.
+ *
+ * A handle names a shard and a reference into its heap. It stays valid
+ * across decrease_keys from any thread until the element is popped.
+ */
+template<typename K, typename I, typename Compare = std::less<K>,
+         typename Heap = HollowHeap<K, I, Compare>>
+class HollowMultiQueue {
+    static_assert(std::is_trivially_copyable<K>::value,
+                  "shard minima are published through std::atomic<K>");
+
+public:
+    typedef K key_type;
+    typedef I item_type;
+
+    struct handle {
+        size_t shard;
+        typename Heap::reference ref;
+    };
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<bool> locked;
+        std::atomic<bool> nonempty;
+        std::atomic<K> top;
+        Heap heap;
+
+        Shard() : locked(false), nonempty(false) {
+        }
+
+        bool try_lock() {
+            return !locked.load(std::memory_order_relaxed) &&
+                   !locked.exchange(true, std::memory_order_acquire);
+        }
+
+        // For operations on one particular shard. Yields now and then, as
+        // the holder may be a preempted thread on the same core.
+        void lock() {
+            for (int spins = 1; !try_lock(); spins++)
+                if (spins % 64 == 0)
+                    std::this_thread::yield();
+        }
+
+        void unlock() {
+            locked.store(false, std::memory_order_release);
+        }
+
+        void publish_top() {
+            const K* key = heap.find_min_key();
+            if (key)
+                top.store(*key, std::memory_order_relaxed);
+            nonempty.store(key != NULL, std::memory_order_release);
+        }
+    };
+
+    Compare compare;
+    size_t num_shards;
+    Shard* shards;
+
+    // xorshift64*, one stream per thread.
+    static uint64_t random() {
+        static std::atomic<uint64_t> seeds(0);
+        static thread_local uint64_t state = (++seeds) * 0x9e3779b97f4a7c15ull;
+
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545f4914f6cdd1dull;
+    }
+
+    size_t random_shard() {
+        return random() % num_shards;
+    }
+
+    // The shard with the smaller published minimum, NULL if both look empty.
+    Shard* better(Shard* a, Shard* b) {
+        bool a_full = a->nonempty.load(std::memory_order_acquire);
+        bool b_full = b->nonempty.load(std::memory_order_acquire);
+        if (!a_full)
+            return b_full ? b : NULL;
+        if (!b_full)
+            return a;
+
+        K a_top = a->top.load(std::memory_order_relaxed);
+        K b_top = b->top.load(std::memory_order_relaxed);
+        return compare(b_top, a_top) ? b : a;
+    }
+
+public:
+    /**
+     * HollowMultiQueue - constructor
+     *
+     * @threads: the number of threads that will use the queue
+     * @c:       shards per thread; more shards mean less contention but
+     *           pops further from the minimum
+     * @compare: the comparator instance to order keys with
+     */
+    HollowMultiQueue(size_t threads, size_t c = 2, const Compare& _compare = Compare())
+        : compare(_compare) {
+        num_shards = c * threads;
+        if (num_shards < 2)
+            num_shards = 2;
+        shards = new Shard[num_shards];
+    }
+
+    HollowMultiQueue(const HollowMultiQueue&) = delete;
+    HollowMultiQueue& operator=(const HollowMultiQueue&) = delete;
+
+    ~HollowMultiQueue() {
+        delete[] shards;
+    }
+
+    /**
+     * push - pushes a (key, item) pair into a random shard
+     *
+     * Returns a handle for the element.
+     */
+    handle push(const key_type& key, const item_type& item) {
+        for (;;) {
+            size_t i = random_shard();
+            Shard* s = shards+i;
+            if (!s->try_lock())
+                continue;
+
+            handle h = { i, s->heap.push(key, item) };
+            if (!s->nonempty.load(std::memory_order_relaxed) ||
+                compare(key, s->top.load(std::memory_order_relaxed)))
+                s->publish_top();
+
+            s->unlock();
+            return h;
+        }
+    }
+
+    /**
+     * try_pop - removes an element with a small key
+     *
+     * @key, @item: receive the element
+     *
+     * Returns false if every shard was empty when it was looked at. With
+     * pushes in flight that doesn't mean the queue is empty for good.
+     */
+    bool try_pop(key_type& key, item_type& item) {
+        for (;;) {
+            size_t a = random_shard(), b = random_shard();
+            Shard* s = better(shards+a, shards+b);
+            if (!s) {
+                if (empty())
+                    return false;
+                continue;
+            }
+
+            if (!s->try_lock())
+                continue;
+            if (s->heap.empty()) {
+                s->unlock();
+                continue;
+            }
+
+            key = *s->heap.find_min_key();
+            item = *s->heap.find_min();
+            s->heap.delete_min();
+            s->publish_top();
+
+            s->unlock();
+            return true;
+        }
+    }
+
+    /**
+     * decrease_key - lowers the key of an element that may have been popped
+     *
+     * @h:       the element's handle
+     * @new_key: the new key; a key that isn't smaller is ignored
+     * @item:    the element's item, to tell it apart from a later element
+     *           that reuses its slot
+     *
+     * Locks the element's shard, waiting for it if need be. Returns false
+     * if the element is no longer in the queue.
+     */
+    bool decrease_key(const handle& h, const key_type& new_key, const item_type& item) {
+        Shard* s = shards+h.shard;
+        s->lock();
+
+        bool found = s->heap.contains(h.ref) && s->heap.item(h.ref) == item;
+        if (found && compare(new_key, s->heap.key(h.ref))) {
+            s->heap.decrease_key(h.ref, new_key);
+            if (compare(new_key, s->top.load(std::memory_order_relaxed)))
+                s->publish_top();
+        }
+
+        s->unlock();
+        return found;
+    }
+
+    /**
+     * empty - tells whether every shard looks empty
+     *
+     * Only a snapshot while other threads are pushing.
+     */
+    bool empty() {
+        for (size_t i = 0; i < num_shards; i++)
+            if (shards[i].nonempty.load(std::memory_order_acquire))
+                return false;
+        return true;
+    }
+};
+
+#endif // _HOLLOW_MULTI_QUEUE_H_
@@ -0,0 +1,493 @@
+#ifndef _INTRUSIVE_HOLLOW_HEAP_H_
+#define _INTRUSIVE_HOLLOW_HEAP_H_
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "hollow_heap.hpp"
+
+/**
+ * HollowHeapHook - the links of an intrusive hollow heap node
+ *
+ * Embed one in every object that goes into an IntrusiveHollowHeap. While
+ * the object is in the heap its hook is a full node of the DAG. Hollow
+ * nodes are hooks too, but they are allocated by the heap and belong to no
+ * object.
+ *
+ * A full node only ever has one parent, so @pprev, which points at the
+ * pointer to the node (its parent's @children or its previous sibling's
+ * @next), is enough to take it out of the DAG in O(1). It is only kept up
+ * to date for full nodes.
+ */
+struct HollowHeapHook {
+    HollowHeapHook* children;
+    HollowHeapHook* next;
+    HollowHeapHook** pprev;
+
+    union {
+        // Hollow nodes: the second parent, whose child list we end.
+        HollowHeapHook* second_parent;
+        // Full nodes: the hollow node that was made our child when we were
+        // last moved, which has us as its second parent unless it has lost
+        // its first one since.
+        HollowHeapHook* second_child;
+    };
+
+    uint8_t rank;
+    bool hollow;
+};
+
+/**
+ * IntrusiveHollowHeap - a hollow heap of objects that carry their own node
+ *
+ * @T:       the object type
+ * @K:       the key type
+ * @Hook:    the HollowHeapHook member of @T
+ * @KeyOf:   a functor that returns the key of a const T&
+ * @Compare: the key order, as for HollowHeap
+ *
+ * The heap stores no keys or items, only pointers into the objects, so
+ * push allocates nothing and find_min returns the object itself. An object
+ * is in at most one heap at a time and must stay put while it's in one.
+ *
+ * Keys are read through @KeyOf whenever two nodes are linked. To decrease
+ * the key of an object, change it in the object first and then call
+ * decrease_key(). That moves the object to a new position and leaves a
+ * hollow node, the only thing the heap allocates, in its old one. Hollow
+ * nodes are never compared, so they don't need a key.
+ */
+template<typename T, typename K, HollowHeapHook T::*Hook, typename KeyOf,
+         typename Compare = std::less<K>>
+class IntrusiveHollowHeap : private HollowHeapCompare<Compare> {
+public:
+    typedef T value_type;
+    typedef K key_type;
+
+private:
+    typedef HollowHeapHook hook;
+
+    using HollowHeapCompare<Compare>::comp;
+
+    KeyOf key_of;
+    hook* root;
+
+    // Same rank map as HollowHeap, with 8-bit ranks.
+    static const int rankmask_words = 4;
+    hook* rankmap[64 * rankmask_words];
+    uint64_t rankmask[rankmask_words];
+
+    inline void set_rank(unsigned rank, hook* u) {
+        rankmap[rank] = u;
+        rankmask[rank / 64] |= (uint64_t) 1 << (rank % 64);
+    }
+
+    inline void clear_rank(unsigned rank) {
+        rankmap[rank] = NULL;
+        rankmask[rank / 64] &= ~((uint64_t) 1 << (rank % 64));
+    }
+
+    hook** to_delete;
+    size_t to_delete_used;
+    size_t to_delete_alloc_size;
+
+    inline void expand_to_delete() {
+        if (to_delete_used >= to_delete_alloc_size) {
+            to_delete_alloc_size *= 2;
+            to_delete = (hook**) realloc(to_delete, to_delete_alloc_size * sizeof(hook*));
+        }
+    }
+
+    // Hollow nodes come from chunks of `chunk_size` hooks and are recycled
+    // through `free_hollow`, chained by `next`.
+    static const size_t chunk_size = 1024;
+
+    std::vector<hook*> chunks;
+    size_t chunks_used;
+    size_t chunk_fill;
+    hook* free_hollow;
+
+    size_t nodes_full;
+    size_t nodes_hollow;
+
+    hook* make_hollow_node() {
+        hook* h;
+        if (free_hollow) {
+            h = free_hollow;
+            free_hollow = h->next;
+        }
+        else {
+            if (chunk_fill == chunk_size || chunks_used == 0) {
+                if (chunks_used == chunks.size())
+                    chunks.push_back((hook*) malloc(chunk_size * sizeof(hook)));
+                chunks_used++;
+                chunk_fill = 0;
+            }
+            h = chunks[chunks_used-1] + chunk_fill++;
+        }
+
+        h->hollow = 1;
+        nodes_hollow++;
+        return h;
+    }
+
+    inline void free_hollow_node(hook* h) {
+        h->next = free_hollow;
+        free_hollow = h;
+        nodes_hollow--;
+    }
+
+    static hook* node(T& value) {
+        return &(value.*Hook);
+    }
+
+    // Where @Hook sits in a T. A member pointer has no offsetof(), so
+    // push() measures it on the object it's given; every hook in the heap
+    // went through push() first.
+    ptrdiff_t hook_offset;
+
+    // container_of() for a member pointer.
+    inline T* owner(hook* h) const {
+        return (T*) ((char*) h - hook_offset);
+    }
+
+    inline const K& key(hook* h) const {
+        return key_of(*owner(h));
+    }
+
+    // Both nodes are full roots.
+    hook* link(hook* u, hook* v) {
+        hook* parent = v;
+        hook* child = u;
+        if (comp()(key(u), key(v)) || (!comp()(key(v), key(u)) && u->rank < v->rank))
+            parent = u, child = v;
+
+        child->next = parent->children;
+        if (child->next && !child->next->hollow)
+            child->next->pprev = &child->next;
+        child->pprev = &parent->children;
+        parent->children = child;
+        return parent;
+    }
+
+    /**
+     * replace - puts a new hollow node in the place of a full non-root node
+     *
+     * @u: the full node to take out of the DAG
+     *
+     * The hollow node takes over @u's position, children and second child,
+     * so @u ends up with no links at all. Returns the hollow node.
+     */
+    hook* replace(hook* u) {
+        hook* h = make_hollow_node();
+
+        h->rank = u->rank;
+        h->second_parent = NULL;
+
+        h->next = u->next;
+        if (h->next && !h->next->hollow)
+            h->next->pprev = &h->next;
+        *u->pprev = h;
+
+        h->children = u->children;
+        if (h->children && !h->children->hollow)
+            h->children->pprev = &h->children;
+        if (u->second_child && u->second_child->second_parent == u)
+            u->second_child->second_parent = h;
+
+        return h;
+    }
+
+    // Hollow nodes below long-lived full nodes are never reached by
+    // delete_min. Don't let them outnumber the elements for too long.
+    inline void limit_hollow() {
+        if (nodes_hollow > 2 * nodes_full + 1024)
+            rebuild();
+    }
+
+    /**
+     * collect_nodes - puts every node of the heap into `to_delete`
+     *
+     * As HollowHeap::collect_nodes, parents first.
+     */
+    void collect_nodes() {
+        to_delete_used = 0;
+        if (!root)
+            return;
+
+        to_delete[to_delete_used++] = root;
+        expand_to_delete();
+
+        for (size_t i = 0; i < to_delete_used; i++) {
+            hook* parent = to_delete[i];
+            for (hook* cur = parent->children; cur; cur = cur->next) {
+                if (cur->hollow && cur->second_parent && cur->second_parent != parent)
+                    continue;
+
+                to_delete[to_delete_used++] = cur;
+                expand_to_delete();
+
+                if (cur->hollow && cur->second_parent == parent)
+                    break;
+            }
+        }
+    }
+
+public:
+    /**
+     * IntrusiveHollowHeap - constructor
+     *
+     * @key_of:  the key extractor instance
+     * @compare: the comparator instance to order keys with
+     */
+    IntrusiveHollowHeap(const KeyOf& _key_of = KeyOf(), const Compare& compare = Compare())
+        : HollowHeapCompare<Compare>(compare), key_of(_key_of) {
+        root = NULL;
+        hook_offset = 0;
+
+        memset(rankmap, 0, sizeof(rankmap));
+        memset(rankmask, 0, sizeof(rankmask));
+
+        to_delete_alloc_size = 32;
+        to_delete = (hook**) malloc(to_delete_alloc_size * sizeof(hook*));
+        to_delete_used = 0;
+
+        chunks_used = 0;
+        chunk_fill = 0;
+        free_hollow = NULL;
+
+        nodes_full = 0;
+        nodes_hollow = 0;
+    }
+
+    IntrusiveHollowHeap(const IntrusiveHollowHeap&) = delete;
+    IntrusiveHollowHeap& operator=(const IntrusiveHollowHeap&) = delete;
+
+    /**
+     * ~IntrusiveHollowHeap - destructor
+     *
+     * Objects still in the heap are left alone; their hooks are garbage.
+     */
+    ~IntrusiveHollowHeap() {
+        for (size_t i = 0; i < chunks.size(); i++)
+            free(chunks[i]);
+        free(to_delete);
+    }
+
+    /**
+     * find_min - returns the object with the minimum key, or NULL if the
+     *            heap is empty
+     */
+    inline T* find_min() {
+        if (!root)
+            return NULL;
+
+        return owner(root);
+    }
+
+    /**
+     * push - pushes an object into the heap
+     *
+     * @value: an object that isn't in any heap
+     */
+    void push(T& value) {
+        hook* u = node(value);
+        DEBUG_PRINT("push %p\n", u);
+
+        hook_offset = (char*) u - (char*) &value;
+
+        u->children = u->next = NULL;
+        u->second_child = NULL;
+        u->rank = 0;
+        u->hollow = 0;
+        nodes_full++;
+
+        if (!root)
+            root = u;
+        else
+            root = link(root, u);
+    }
+
+    /**
+     * decrease_key - restores the heap after an object's key was decreased
+     *
+     * @value: an object in the heap whose key has just been lowered
+     *
+     * Allocates one hollow node unless @value is the minimum.
+     */
+    void decrease_key(T& value) {
+        hook* u = node(value);
+        DEBUG_PRINT("decreasing %p\n", u);
+
+        if (u == root)
+            return;
+
+        hook* h = replace(u);
+
+        u->children = u->next = NULL;
+        u->second_child = NULL;
+        if (u->rank > 2)
+            u->rank -= 2;
+        else
+            u->rank = 0;
+
+        // If the root stays the winner, the hollow node gains a second
+        // parent in the form of the moved node.
+        hook* old_root = root;
+        root = link(root, u);
+        if (root == old_root) {
+            u->children = h;
+            u->second_child = h;
+            h->second_parent = u;
+        }
+
+        limit_hollow();
+    }
+
+    /**
+     * delete_min - removes the object with the minimum key
+     */
+    void delete_min() {
+        if (!root)
+            return;
+
+        nodes_full--;
+        remove_root();
+    }
+
+    /**
+     * erase - removes an arbitrary object from the heap
+     *
+     * @value: an object in the heap
+     *
+     * Leaves a hollow node in the object's place, so the object can be
+     * destroyed right away. Takes O(1) unless @value is the minimum.
+     */
+    void erase(T& value) {
+        hook* u = node(value);
+        DEBUG_PRINT("erasing %p\n", u);
+
+        nodes_full--;
+        if (u == root) {
+            remove_root();
+            return;
+        }
+
+        replace(u);
+        limit_hollow();
+    }
+
+    /**
+     * rebuild - discards all hollow nodes and relinks the full ones
+     *
+     * As HollowHeap::rebuild; costs O(nodes in use).
+     */
+    void rebuild() {
+        collect_nodes();
+
+        root = NULL;
+        for (size_t i = 0; i < to_delete_used; i++) {
+            hook* u = to_delete[i];
+            if (u->hollow)
+                continue;
+
+            u->children = u->next = NULL;
+            u->second_child = NULL;
+            u->rank = 0;
+
+            if (!root)
+                root = u;
+            else
+                root = link(root, u);
+        }
+
+        for (size_t i = 0; i < to_delete_used; i++)
+            if (to_delete[i]->hollow)
+                free_hollow_node(to_delete[i]);
+    }
+
+    /**
+     * clear - removes every object, keeping the hollow node chunks
+     */
+    void clear() {
+        root = NULL;
+        chunks_used = 0;
+        chunk_fill = 0;
+        free_hollow = NULL;
+
+        nodes_full = 0;
+        nodes_hollow = 0;
+    }
+
+    inline bool empty() {
+        return root == NULL;
+    }
+
+private:
+    /**
+     * remove_root - removes the root and builds a new one from its children
+     *
+     * The root is always full and so is the winner of the final links,
+     * which are only ever between full nodes.
+     */
+    void remove_root() {
+        to_delete_used = 0;
+        to_delete[to_delete_used++] = root;
+        expand_to_delete();
+
+        for (size_t i = 0; i < to_delete_used; i++) {
+            hook* parent = to_delete[i];
+
+            hook* cur = parent->children;
+            while (cur) {
+                hook* next = cur->next;
+
+                if (!cur->hollow) {
+                    while (rankmap[cur->rank]) {
+                        hook* other = rankmap[cur->rank];
+
+                        clear_rank(cur->rank);
+                        cur = link(cur, other);
+                        cur->rank++;
+                    }
+
+                    set_rank(cur->rank, cur);
+                }
+                else if (!cur->second_parent) {
+                    to_delete[to_delete_used++] = cur;
+                    expand_to_delete();
+                }
+                else if (cur->second_parent == parent) {
+                    cur->second_parent = NULL;
+                    break;
+                }
+                else {
+                    cur->second_parent = NULL;
+                    cur->next = NULL;
+                }
+
+                cur = next;
+            }
+        }
+
+        // The old root belongs to its object; the rest were hollow.
+        for (size_t i = 1; i < to_delete_used; i++)
+            free_hollow_node(to_delete[i]);
+
+        root = NULL;
+        for (int w = rankmask_words-1; w >= 0; w--) {
+            while (rankmask[w]) {
+                unsigned rank = 64*w + 63 - __builtin_clzll(rankmask[w]);
+                hook* u = rankmap[rank];
+
+                clear_rank(rank);
+                root = root ? link(root, u) : u;
+            }
+        }
+    }
+};
+
+#endif // _INTRUSIVE_HOLLOW_HEAP_H_